@@ -46,8 +46,7 @@ class InvalidNumberOfSamplingBlocksException : public std::exception
 public:
     const char* what() const noexcept
     {
-        return "The number of indices in the sampling blocks does not match "
-               "the "
+        return "The number of indices in the sampling blocks exceeds the "
                "number of joints (joint state dimension) of the robot.";
     }
 };
@@ -25,6 +25,7 @@
 #include <dbrt/builder/factorized_transition_builder.h>
 #include <dbrt/builder/rotary_sensor_builder.h>
 #include <dbrt/kinematics_from_urdf.h>
+#include <dbrt/tracker/rotary_filter_batch.h>
 #include <dbrt/tracker/rotary_tracker.h>
 #include <exception>
 
@@ -57,8 +58,10 @@ public:
     std::shared_ptr<Tracker> build()
     {
         auto joint_filters = create_joint_filters();
+        auto filter_batch = create_filter_batch();
 
-        auto tracker = std::make_shared<Tracker>(joint_filters, kinematics_);
+        auto tracker = std::make_shared<Tracker>(
+            joint_filters, filter_batch, kinematics_);
 
         return tracker;
     }
@@ -67,7 +70,7 @@ public:
     {
         auto joint_filters = std::make_shared<std::vector<JointFilter>>();
 
-        for (int i = 0; i < kinematics_->num_joints(); ++i)
+        for (int i = 0; i < kinematics_->num_robot_joints(); ++i)
         {
             auto transition = this->transition_builder_->build(i);
             auto sensor = this->sensor_builder_->build(i);
@@ -79,6 +82,35 @@ public:
         return joint_filters;
     }
 
+    /**
+     * \brief Creates the batched filters of all joints using the same
+     *        transition and sensor models as create_joint_filters()
+     */
+    virtual std::shared_ptr<RotaryFilterBatch> create_filter_batch()
+    {
+        auto filter_batch = std::make_shared<RotaryFilterBatch>(
+            kinematics_->num_robot_joints());
+
+        for (int i = 0; i < kinematics_->num_robot_joints(); ++i)
+        {
+            auto transition = this->transition_builder_->build(i);
+            auto sensor = this->sensor_builder_->build(i);
+
+            // the models are parametrized by the square roots of their noise
+            // covariances
+            auto noise = transition->noise_matrix();
+            auto sensor_noise = sensor->noise_matrix();
+
+            filter_batch->set_joint_model(
+                i,
+                transition->dynamics_matrix(),
+                noise * noise.transpose(),
+                sensor->sensor_matrix(),
+                (sensor_noise * sensor_noise.transpose())(0, 0));
+        }
+        return filter_batch;
+    }
+
 protected:
     std::shared_ptr<KinematicsFromURDF> kinematics_;
     std::shared_ptr<FactorizedTransitionBuilder<Tracker>> transition_builder_;
@@ -100,7 +100,8 @@ public:
             filter,
             this->object_model_,
             this->params_.evaluation_count,
-            this->params_.sampling_blocks.size());
+            this->params_.sampling_blocks.size(),
+            urdf_kinematics_->camera_offset_joint_indices());
 
         return tracker;
     }
@@ -109,7 +110,9 @@ public:
         const std::shared_ptr<dbot::ObjectModel>& object_model,
         double max_kl_divergence)
     {
-        if (count_sampling_block_indices(params_.sampling_blocks) !=
+        // state entries which are not part of any block are not sampled,
+        // e.g. the camera offset if it is estimated separately
+        if (count_sampling_block_indices(params_.sampling_blocks) >
             urdf_kinematics_->num_joints())
         {
             throw InvalidNumberOfSamplingBlocksException();
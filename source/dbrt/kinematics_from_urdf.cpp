@@ -19,10 +19,25 @@
  * \author Manuel Wuthrich (manuel.wuthrich@gmail.com)
  */
 
+#include <algorithm>
 #include <boost/random/normal_distribution.hpp>
+#include <cmath>
 #include <dbrt/kinematics_from_urdf.h>
 #include <fl/util/profiling.hpp>
 
+#ifdef DBRT_GENERATED_KINEMATICS
+#include <dbrt/generated_kinematics.h>
+#endif
+
+/**
+ * \brief Returns a model version which no instance has used before
+ */
+static std::uint64_t next_model_version()
+{
+    static std::atomic<std::uint64_t> last_model_version(0);
+    return ++last_model_version;
+}
+
 KinematicsFromURDF::KinematicsFromURDF(
     const std::string& robot_description,
     const std::string& robot_description_package_path,
@@ -34,18 +49,22 @@ KinematicsFromURDF::KinematicsFromURDF(
       rendering_root_left_(rendering_root_left),
       rendering_root_right_(rendering_root_right),
       cam_frame_name_(camera_frame_id),
-      use_camera_offset_(use_camera_offset)
+      use_camera_offset_(use_camera_offset),
+      camera_segment_(-1),
+      use_generated_kinematics_(false),
+      frames_valid_(false),
+      recomputed_link_count_(0),
+      published_camera_offset_(std::make_shared<PublishedCameraOffset>()),
+      camera_offset_version_(0),
+      model_version_(next_model_version())
 {
-    camera_offset_.setZero();
+    camera_offset_.setZero(use_camera_offset_ ? camera_offset_dim : 0);
+    published_camera_offset_->offset.setZero(camera_offset_dim);
+    published_camera_offset_->version = 0;
 
     // Initialize URDF object from robot description
     if (!urdf_.initString(robot_description)) ROS_ERROR("Failed to parse urdf");
 
-    if (use_camera_offset_)
-    {
-        inject_offset_joints_and_links(cam_frame_name_, urdf_);
-    }
-
     // set up kinematic tree from URDF
     if (!kdl_parser::treeFromUrdfModel(urdf_, kin_tree_))
     {
@@ -84,132 +103,470 @@ KinematicsFromURDF::KinematicsFromURDF(
         }
     }
 
-    // initialise kinematic tree solver
-    tree_solver_ = new KDL::TreeFkSolverPos_recursive(kin_tree_);
+    for (int i = 0; i < joint_map_.size(); ++i)
+    {
+        joint_index_map_[joint_map_[i]] = i;
+    }
+
+    // the camera offset is not part of the kinematic tree. Its six values
+    // follow the robot joints in the state and keep the names of the former
+    // offset joints such that the offset parameters still apply.
+    if (use_camera_offset_)
+    {
+        for (auto suffix : {"_X_JOINT",
+                            "_Y_JOINT",
+                            "_Z_JOINT",
+                            "_PITCH_JOINT",
+                            "_YAW_JOINT",
+                            "_ROLL_JOINT"})
+        {
+            const int index = joint_map_.size();
+            joint_map_.push_back(cam_frame_name_ + suffix);
+            joint_index_map_[joint_map_.back()] = index;
+            camera_offset_joint_indices_.push_back(index);
+        }
+    }
+
+    build_segment_list();
 }
 
-void KinematicsFromURDF::rename_camera_frame(const std::string& camera_frame,
-                                             urdf::Model& urdf)
+KinematicsFromURDF::KinematicsFromURDF(const KinematicsFromURDF& other)
+    : description_path_(other.description_path_),
+      urdf_(other.urdf_),
+      kin_tree_(other.kin_tree_),
+      joint_map_(other.joint_map_),
+      joint_index_map_(other.joint_index_map_),
+      mesh_names_(other.mesh_names_),
+      mesh_segments_(other.mesh_segments_),
+      link_frames_(other.link_frames_.size()),
+      link_poses_(other.link_poses_.size()),
+      segments_(other.segments_),
+      segment_parents_(other.segment_parents_),
+      segment_joint_indices_(other.segment_joint_indices_),
+      segment_frames_(other.segment_frames_.size()),
+      segment_index_map_(other.segment_index_map_),
+      camera_segment_(other.camera_segment_),
+      segment_models_(other.segment_models_),
+      use_generated_kinematics_(other.use_generated_kinematics_),
+      generated_frames_(other.generated_frames_.size()),
+      frames_valid_(false),
+      joint_changed_(other.joint_changed_.size()),
+      segment_dirty_(other.segment_dirty_.size()),
+      recomputed_link_count_(0),
+      cam_frame_name_(other.cam_frame_name_),
+      rendering_root_left_(other.rendering_root_left_),
+      rendering_root_right_(other.rendering_root_right_),
+      use_camera_offset_(other.use_camera_offset_),
+      camera_offset_(other.camera_offset_),
+      camera_offset_frame_(other.camera_offset_frame_),
+      camera_offset_joint_indices_(other.camera_offset_joint_indices_),
+      published_camera_offset_(other.published_camera_offset_),
+      camera_offset_version_(other.camera_offset_version_),
+      model_version_(other.model_version_.load())
 {
-    // rename joint child link name of the camera
-    for (auto& joint_entry : urdf.joints_)
+    // only the immutable model is copied. The frame buffers are computed on
+    // the first set_joint_angles() call of the clone.
+}
+
+KinematicsFromURDF::~KinematicsFromURDF()
+{
+}
+
+std::shared_ptr<KinematicsFromURDF> KinematicsFromURDF::clone() const
+{
+    std::lock_guard<std::mutex> lock(model_mutex_);
+    return std::shared_ptr<KinematicsFromURDF>(new KinematicsFromURDF(*this));
+}
+
+/**
+ * \brief Decomposes the segment pose such that it can be evaluated for many
+ *        joint values with plain arithmetic
+ */
+auto KinematicsFromURDF::create_segment_model(const KDL::Segment& segment)
+    -> SegmentModel
+{
+    SegmentModel model;
+
+    const KDL::Joint& joint = segment.getJoint();
+    model.origin = joint.pose(0);
+    model.tip = model.origin.Inverse() * segment.pose(0);
+    model.axis = KDL::Vector::Zero();
+    model.scale = 0;
+
+    if (joint.getType() == KDL::Joint::None)
     {
-        auto& joint = joint_entry.second;
-        if (joint->child_link_name == camera_frame)
-        {
-            joint->child_link_name += "_DEFAULT";
+        model.type = SegmentModel::Fixed;
+        return model;
+    }
+
+    // the motion for a unit joint value reveals the axis and the scale
+    KDL::Frame motion = model.origin.Inverse() * joint.pose(1.0);
+    switch (joint.getType())
+    {
+        case KDL::Joint::RotAxis:
+        case KDL::Joint::RotX:
+        case KDL::Joint::RotY:
+        case KDL::Joint::RotZ:
+            model.type = SegmentModel::Rotational;
+            model.scale = motion.M.GetRotAngle(model.axis);
+            break;
+        default:
+            model.type = SegmentModel::Translational;
+            model.axis = motion.p;
+            model.scale = model.axis.Normalize();
             break;
-        }
     }
 
-    // rename camera link name
-    for (auto& link_entry : urdf.links_)
+    return model;
+}
+
+/**
+ * \brief out = a * b for count frames a and the constant frame b. out may
+ *        be a.
+ */
+static void compose_batch(double* const a[],
+                          const KDL::Frame& b,
+                          double* const out[],
+                          int count)
+{
+    const KDL::Rotation& M = b.M;
+    const KDL::Vector& p = b.p;
+
+    for (int n = 0; n < count; ++n)
     {
-        auto& link = link_entry.second;
-        if (link->name == camera_frame)
-        {
-            // rename link name
-            link->name += "_DEFAULT";
+        const double a00 = a[0][n], a01 = a[1][n], a02 = a[2][n];
+        const double a10 = a[3][n], a11 = a[4][n], a12 = a[5][n];
+        const double a20 = a[6][n], a21 = a[7][n], a22 = a[8][n];
+        const double ax = a[9][n], ay = a[10][n], az = a[11][n];
+
+        out[0][n] = a00 * M(0, 0) + a01 * M(1, 0) + a02 * M(2, 0);
+        out[1][n] = a00 * M(0, 1) + a01 * M(1, 1) + a02 * M(2, 1);
+        out[2][n] = a00 * M(0, 2) + a01 * M(1, 2) + a02 * M(2, 2);
+        out[3][n] = a10 * M(0, 0) + a11 * M(1, 0) + a12 * M(2, 0);
+        out[4][n] = a10 * M(0, 1) + a11 * M(1, 1) + a12 * M(2, 1);
+        out[5][n] = a10 * M(0, 2) + a11 * M(1, 2) + a12 * M(2, 2);
+        out[6][n] = a20 * M(0, 0) + a21 * M(1, 0) + a22 * M(2, 0);
+        out[7][n] = a20 * M(0, 1) + a21 * M(1, 1) + a22 * M(2, 1);
+        out[8][n] = a20 * M(0, 2) + a21 * M(1, 2) + a22 * M(2, 2);
+        out[9][n] = a00 * p.x() + a01 * p.y() + a02 * p.z() + ax;
+        out[10][n] = a10 * p.x() + a11 * p.y() + a12 * p.z() + ay;
+        out[11][n] = a20 * p.x() + a21 * p.y() + a22 * p.z() + az;
+    }
+}
 
-            // add new entry using the new name
-            urdf.links_[link->name] = link;
+/**
+ * \brief Applies the joint motion of the given segment model to count
+ *        frames in place, i.e. f = f * motion(q)
+ */
+void KinematicsFromURDF::apply_motion_batch(const SegmentModel& model,
+                                            const double* q,
+                                            double* const f[frame_size],
+                                            int count)
+{
+    const double x = model.axis.x();
+    const double y = model.axis.y();
+    const double z = model.axis.z();
 
-            // remove old entry mapped by old name
-            auto camera_link_it = urdf.links_.find(camera_frame);
-            urdf.links_.erase(camera_link_it);
+    if (model.type == SegmentModel::Translational)
+    {
+        for (int n = 0; n < count; ++n)
+        {
+            const double d = model.scale * q[n];
+            f[9][n] += (f[0][n] * x + f[1][n] * y + f[2][n] * z) * d;
+            f[10][n] += (f[3][n] * x + f[4][n] * y + f[5][n] * z) * d;
+            f[11][n] += (f[6][n] * x + f[7][n] * y + f[8][n] * z) * d;
+        }
+        return;
+    }
 
-            return;
+    for (int n = 0; n < count; ++n)
+    {
+        // Rodrigues' rotation about the unit axis
+        const double angle = model.scale * q[n];
+        const double c = std::cos(angle);
+        const double s = std::sin(angle);
+        const double t = 1.0 - c;
+
+        const double r00 = c + x * x * t;
+        const double r01 = x * y * t - z * s;
+        const double r02 = x * z * t + y * s;
+        const double r10 = y * x * t + z * s;
+        const double r11 = c + y * y * t;
+        const double r12 = y * z * t - x * s;
+        const double r20 = z * x * t - y * s;
+        const double r21 = z * y * t + x * s;
+        const double r22 = c + z * z * t;
+
+        for (int row = 0; row < 3; ++row)
+        {
+            const double m0 = f[3 * row][n];
+            const double m1 = f[3 * row + 1][n];
+            const double m2 = f[3 * row + 2][n];
+            f[3 * row][n] = m0 * r00 + m1 * r10 + m2 * r20;
+            f[3 * row + 1][n] = m0 * r01 + m1 * r11 + m2 * r21;
+            f[3 * row + 2][n] = m0 * r02 + m1 * r12 + m2 * r22;
         }
     }
+}
 
-    ROS_ERROR_STREAM("Camera frame ID" << camera_frame
-                                       << " does not exist in URDF.");
+/**
+ * \brief Quaternion of the row-major rotation matrix r, computed like
+ *        KDL::Rotation::GetQuaternion()
+ */
+static void rotation_to_quaternion(
+    const double r[9], double& x, double& y, double& z, double& w)
+{
+    const double trace = r[0] + r[4] + r[8];
+    if (trace > 1e-12)
+    {
+        const double s = 0.5 / std::sqrt(trace + 1.0);
+        w = 0.25 / s;
+        x = (r[7] - r[5]) * s;
+        y = (r[2] - r[6]) * s;
+        z = (r[3] - r[1]) * s;
+    }
+    else if (r[0] > r[4] && r[0] > r[8])
+    {
+        const double s = 2.0 * std::sqrt(1.0 + r[0] - r[4] - r[8]);
+        w = (r[7] - r[5]) / s;
+        x = 0.25 * s;
+        y = (r[1] + r[3]) / s;
+        z = (r[2] + r[6]) / s;
+    }
+    else if (r[4] > r[8])
+    {
+        const double s = 2.0 * std::sqrt(1.0 + r[4] - r[0] - r[8]);
+        w = (r[2] - r[6]) / s;
+        x = (r[1] + r[3]) / s;
+        y = 0.25 * s;
+        z = (r[5] + r[7]) / s;
+    }
+    else
+    {
+        const double s = 2.0 * std::sqrt(1.0 + r[8] - r[0] - r[4]);
+        w = (r[3] - r[1]) / s;
+        x = (r[2] + r[6]) / s;
+        y = (r[5] + r[7]) / s;
+        z = 0.25 * s;
+    }
 }
 
-void KinematicsFromURDF::inject_offset_joints_and_links(
-    const std::string& camera_frame,
-    urdf::Model& urdf)
+void KinematicsFromURDF::compute_link_poses(const BatchMatrix& joint_states,
+                                            LinkPoseBatch& poses) const
 {
-    rename_camera_frame(camera_frame, urdf);
+    const int count = joint_states.cols();
+    const int link_count = mesh_segments_.size();
 
-//    std::string camera_frame_ = "camera";
-    std::vector<std::string> dofs = {camera_frame + "_X",
-                                     camera_frame + "_Y",
-                                     camera_frame + "_Z",
-                                     camera_frame + "_PITCH",
-                                     camera_frame + "_YAW",
-                                     camera_frame + "_ROLL"};
+    poses.segment_frames.resize(segments_.size() * frame_size * count);
 
-    std::string current_parent_link = camera_frame + "_DEFAULT";
+    auto frame = [&](int segment, double* f[frame_size]) {
+        double* data = &poses.segment_frames[segment * frame_size * count];
+        for (int k = 0; k < frame_size; ++k) f[k] = data + k * count;
+    };
 
-    for (int i = 0; i < dofs.size(); ++i)
+    // single root to leaf pass evaluating each segment for all joint states
+    double* f[frame_size];
+    double* parent_f[frame_size];
+    for (size_t i = 0; i < segments_.size(); ++i)
     {
-        // construct joint
-        auto joint = boost::make_shared<urdf::Joint>();
-        joint->name = dofs[i] + "_JOINT";
-        joint->type = i < 3 ? urdf::Joint::PRISMATIC : urdf::Joint::REVOLUTE;
-        joint->axis.x = double(i == 0 || i == 3);
-        joint->axis.y = double(i == 1 || i == 4);
-        joint->axis.z = double(i == 2 || i == 5);
-        joint->child_link_name = dofs[i] + "_LINK";
-        joint->parent_link_name = current_parent_link;
+        const SegmentModel& model = segment_models_[i];
+        frame(i, f);
 
-        // add joint
-        urdf.joints_[joint->name] = joint;
-
-        // update parent link name for next joint
-        current_parent_link = joint->child_link_name;
+        if (segment_parents_[i] < 0)
+        {
+            // start from the identity
+            for (int k = 0; k < frame_size; ++k)
+            {
+                const double value = (k == 0 || k == 4 || k == 8) ? 1.0 : 0.0;
+                std::fill(f[k], f[k] + count, value);
+            }
+            compose_batch(f, model.origin, f, count);
+        }
+        else
+        {
+            frame(segment_parents_[i], parent_f);
+            compose_batch(parent_f, model.origin, f, count);
+        }
 
-        // last dof has no link
-        if (i > 4) continue;
+        if (model.type != SegmentModel::Fixed)
+        {
+            const double* q =
+                joint_states.row(segment_joint_indices_[i]).data();
+            apply_motion_batch(model, q, f, count);
+        }
 
-        auto link = boost::make_shared<urdf::Link>();
-        link->name = dofs[i] + "_LINK";
-        link->parent_joint = joint;
+        compose_batch(f, model.tip, f, count);
+    }
 
-        // add link
-        urdf.links_[link->name] = link;
+    poses.px.resize(link_count, count);
+    poses.py.resize(link_count, count);
+    poses.pz.resize(link_count, count);
+    poses.qx.resize(link_count, count);
+    poses.qy.resize(link_count, count);
+    poses.qz.resize(link_count, count);
+    poses.qw.resize(link_count, count);
+
+    // express the links in the camera frame, c^-1 * f with the camera frame c
+    // and its offset. The inverse is computed once per joint state.
+    poses.camera_frames.resize(frame_size * count);
+    double* inverse[frame_size];
+    for (int k = 0; k < frame_size; ++k)
+    {
+        inverse[k] = &poses.camera_frames[k * count];
     }
 
-    // update camera root link child joints and links
-    auto camera_root_link = urdf.links_[camera_frame + "_DEFAULT"];
-    camera_root_link->child_joints.push_back(urdf.joints_[dofs[0] + "_JOINT"]);
-    camera_root_link->child_links.push_back(urdf.links_[dofs[0] + "_LINK"]);
+    double* c[frame_size];
+    if (camera_segment_ >= 0) frame(camera_segment_, c);
 
-    // add leaf original camera frame
-    auto camera_leaf_link = boost::make_shared<urdf::Link>();
-    camera_leaf_link->name = camera_frame;
-    camera_leaf_link->parent_joint = urdf.joints_[dofs[5] + "_JOINT"];
-    urdf.links_[camera_frame] = camera_leaf_link;
+    // without an offset in the state, the published offset applies to all
+    // joint states
+    double offset[camera_offset_dim];
+    const Eigen::VectorXd published_offset = camera_offset();
+    KDL::Frame offset_frame = camera_offset_to_frame(published_offset.data());
 
-    for (int i = 0; i < dofs.size() - 1; ++i)
+    for (int n = 0; n < count; ++n)
     {
-        auto link = urdf.links_[dofs[i] + "_LINK"];
-        link->child_joints.push_back(urdf.joints_[dofs[i + 1] + "_JOINT"]);
+        KDL::Frame camera = KDL::Frame::Identity();
+        if (camera_segment_ >= 0)
+        {
+            camera = KDL::Frame(
+                KDL::Rotation(c[0][n], c[1][n], c[2][n],
+                              c[3][n], c[4][n], c[5][n],
+                              c[6][n], c[7][n], c[8][n]),
+                KDL::Vector(c[9][n], c[10][n], c[11][n]));
+        }
+
+        if (use_camera_offset_)
+        {
+            for (int k = 0; k < camera_offset_dim; ++k)
+            {
+                offset[k] = joint_states(camera_offset_joint_indices_[k], n);
+            }
+            offset_frame = camera_offset_to_frame(offset);
+        }
 
-        // ROLL is the last joint and the next link is the camera frame.
-        // This means there is no ROLL link and there fore we do the next step
-        // until PITCH link and YAW obtains the camera frame as child link
-        if (i < dofs.size() - 2)
+        const KDL::Frame camera_inverse = (camera * offset_frame).Inverse();
+        for (int k = 0; k < 9; ++k)
         {
-            link->child_links.push_back(urdf.links_[dofs[i + 1] + "_LINK"]);
+            inverse[k][n] = camera_inverse.M.data[k];
         }
-        else
+        for (int k = 0; k < 3; ++k)
+        {
+            inverse[9 + k][n] = camera_inverse.p.data[k];
+        }
+    }
+
+    for (int i = 0; i < link_count; ++i)
+    {
+        frame(mesh_segments_[i], f);
+
+        double* px = poses.px.row(i).data();
+        double* py = poses.py.row(i).data();
+        double* pz = poses.pz.row(i).data();
+        double* qx = poses.qx.row(i).data();
+        double* qy = poses.qy.row(i).data();
+        double* qz = poses.qz.row(i).data();
+        double* qw = poses.qw.row(i).data();
+
+        for (int n = 0; n < count; ++n)
         {
-            // Second las link has the camera frame as child link
-            link->child_links.push_back(urdf.links_[camera_frame]);
+            double r[9];
+            for (int row = 0; row < 3; ++row)
+            {
+                const double m0 = inverse[3 * row][n];
+                const double m1 = inverse[3 * row + 1][n];
+                const double m2 = inverse[3 * row + 2][n];
+                for (int col = 0; col < 3; ++col)
+                {
+                    r[3 * row + col] = m0 * f[col][n] + m1 * f[3 + col][n] +
+                                       m2 * f[6 + col][n];
+                }
+            }
+            px[n] = inverse[0][n] * f[9][n] + inverse[1][n] * f[10][n] +
+                    inverse[2][n] * f[11][n] + inverse[9][n];
+            py[n] = inverse[3][n] * f[9][n] + inverse[4][n] * f[10][n] +
+                    inverse[5][n] * f[11][n] + inverse[10][n];
+            pz[n] = inverse[6][n] * f[9][n] + inverse[7][n] * f[10][n] +
+                    inverse[8][n] * f[11][n] + inverse[11][n];
+
+            rotation_to_quaternion(r, qx[n], qy[n], qz[n], qw[n]);
         }
     }
 }
 
-KinematicsFromURDF::~KinematicsFromURDF()
+void KinematicsFromURDF::build_segment_list()
 {
-    delete tree_solver_;
+    // depth first traversal from the root such that each segment is visited
+    // after its parent
+    std::vector<std::pair<KDL::SegmentMap::const_iterator, int>> stack;
+    stack.push_back(std::make_pair(kin_tree_.getRootSegment(), -1));
+
+    while (!stack.empty())
+    {
+        auto element = stack.back().first;
+        int parent = stack.back().second;
+        stack.pop_back();
+
+        const KDL::Segment& segment = element->second.segment;
+        int index = segments_.size();
+
+        segments_.push_back(segment);
+        segment_parents_.push_back(parent);
+        segment_joint_indices_.push_back(
+            segment.getJoint().getType() != KDL::Joint::None
+                ? int(element->second.q_nr)
+                : -1);
+        segment_index_map_[segment.getName()] = index;
+        segment_models_.push_back(create_segment_model(segment));
+
+        // push in reverse order to visit the children in their original order
+        const auto& children = element->second.children;
+        for (auto child = children.rbegin(); child != children.rend(); ++child)
+        {
+            stack.push_back(std::make_pair(*child, index));
+        }
+    }
+
+    segment_frames_.resize(segments_.size());
+    segment_dirty_.resize(segments_.size());
+    joint_changed_.resize(kin_tree_.getNrOfJoints());
+
+    auto camera_segment = segment_index_map_.find(cam_frame_name_);
+    if (camera_segment == segment_index_map_.end())
+    {
+        ROS_ERROR("Camera frame %s is not part of the kinematic tree",
+                  cam_frame_name_.c_str());
+    }
+    else
+    {
+        camera_segment_ = camera_segment->second;
+    }
+
+#ifdef DBRT_GENERATED_KINEMATICS
+    use_generated_kinematics_ =
+        dbrt::generated_kinematics::fingerprint == model_fingerprint();
+    if (use_generated_kinematics_)
+    {
+        generated_frames_.resize(segments_.size() * frame_size);
+    }
+    else
+    {
+        ROS_WARN(
+            "The generated kinematics do not match the robot description. "
+            "Falling back to the generic forward kinematics.");
+    }
+#endif
 }
 
 void KinematicsFromURDF::get_part_meshes(
     std::vector<boost::shared_ptr<PartMeshModel>>& part_meshes)
 {
+    std::lock_guard<std::mutex> lock(model_mutex_);
+
+    // the meshes are loaded anew, e.g. by every tracker rendering the robot
+    mesh_names_.clear();
+    mesh_segments_.clear();
+
     // Load robot mesh for each link
     std::vector<boost::shared_ptr<urdf::Link>> links;
     urdf_.getLinks(links);
@@ -232,15 +589,31 @@ void KinematicsFromURDF::get_part_meshes(
 
         if (part_ptr->proper_)  // if the link has an actual mesh file to read
         {
+            auto segment = segment_index_map_.find(part_ptr->get_name());
+            if (segment == segment_index_map_.end())
+            {
+                ROS_ERROR("Link %s is not part of the kinematic tree",
+                          part_ptr->get_name().c_str());
+                continue;
+            }
+
             part_meshes.push_back(part_ptr);
             mesh_names_.push_back(part_ptr->get_name());
+            mesh_segments_.push_back(segment->second);
         }
     }
+
+    // force the link frames of the new meshes to be computed
+    link_frames_.resize(mesh_segments_.size());
+    link_poses_.resize(mesh_segments_.size());
+    frames_valid_ = false;
+
+    model_version_ = next_model_version();
 }
 
 void KinematicsFromURDF::check_size(int size)
 {
-    int expected_size = kin_tree_.getNrOfJoints();
+    int expected_size = num_joints();
 
     if (expected_size != size)
     {
@@ -255,47 +628,367 @@ void KinematicsFromURDF::set_joint_angles(const Eigen::VectorXd& joint_state)
 {
     check_size(joint_state.size());
 
+    // the camera offset is either part of the state or has been published
+    bool camera_offset_changed = false;
+    if (use_camera_offset_)
+    {
+        camera_offset_changed =
+            update_camera_offset(joint_state.tail(camera_offset_dim));
+    }
+    else if (published_camera_offset_->version != camera_offset_version_)
+    {
+        camera_offset_changed = apply_published_camera_offset();
+    }
+
     // Internally, KDL array use Eigen Vectors
-    if (jnt_array_.data.size() == 0 || !jnt_array_.data.isApprox(joint_state))
+    if (!frames_valid_ || jnt_array_.data.size() != num_robot_joints())
     {
-        jnt_array_.data = joint_state.topRows(kin_tree_.getNrOfJoints());
+        jnt_array_.data = joint_state.topRows(num_robot_joints());
         // Given the new joint angles, compute all link transforms in one go
-        compute_transforms();
+        compute_transforms(true, true);
+        frames_valid_ = true;
+        return;
+    }
+
+    // only the subtrees below changed joints have to be recomputed
+    bool changed = false;
+    for (int i = 0; i < joint_changed_.size(); ++i)
+    {
+        joint_changed_[i] = jnt_array_(i) != joint_state(i);
+        if (joint_changed_[i])
+        {
+            jnt_array_(i) = joint_state(i);
+            changed = true;
+        }
+    }
+
+    if (changed || camera_offset_changed)
+    {
+        compute_transforms(false, camera_offset_changed);
     }
 }
 
-void KinematicsFromURDF::compute_transforms()
+void KinematicsFromURDF::set_camera_offset(const Eigen::VectorXd& offset)
 {
-    // get the transform from base to camera
-    if (tree_solver_->JntToCart(jnt_array_, cam_frame_, cam_frame_name_) < 0)
-        ROS_ERROR("TreeSolver returned an error for link %s",
-                  cam_frame_name_.c_str());
-    cam_frame_ = cam_frame_.Inverse();
+    if (offset.size() != camera_offset_dim)
+    {
+        ROS_ERROR("Camera offset must have %d entries", camera_offset_dim);
+        return;
+    }
 
-    // loop over all segments to compute the link transformation
-    for (KDL::SegmentMap::const_iterator seg_it = segment_map_.begin();
-         seg_it != segment_map_.end();
-         ++seg_it)
+    std::lock_guard<std::mutex> lock(published_camera_offset_->mutex);
+    published_camera_offset_->offset = offset;
+    published_camera_offset_->version++;
+}
+
+Eigen::VectorXd KinematicsFromURDF::camera_offset() const
+{
+    std::lock_guard<std::mutex> lock(published_camera_offset_->mutex);
+    return published_camera_offset_->offset;
+}
+
+std::uint64_t KinematicsFromURDF::camera_offset_version() const
+{
+    return published_camera_offset_->version;
+}
+
+bool KinematicsFromURDF::apply_published_camera_offset()
+{
+    Eigen::Matrix<double, camera_offset_dim, 1> offset;
+    {
+        std::lock_guard<std::mutex> lock(published_camera_offset_->mutex);
+        offset = published_camera_offset_->offset;
+        camera_offset_version_ = published_camera_offset_->version;
+    }
+
+    return update_camera_offset(offset);
+}
+
+bool KinematicsFromURDF::update_camera_offset(
+    const Eigen::Ref<const Eigen::VectorXd>& offset)
+{
+    if (camera_offset_.size() == offset.size() && camera_offset_ == offset)
+    {
+        return false;
+    }
+
+    camera_offset_ = offset;
+    camera_offset_frame_ = camera_offset_to_frame(offset.data());
+
+    return true;
+}
+
+/**
+ * \brief Offset transform of the camera given x, y, z, pitch, yaw and roll,
+ *        i.e. a translation followed by rotations about the x, y and z axes
+ */
+KDL::Frame KinematicsFromURDF::camera_offset_to_frame(const double* offset)
+{
+    return KDL::Frame(KDL::Rotation::RotX(offset[3]) *
+                          KDL::Rotation::RotY(offset[4]) *
+                          KDL::Rotation::RotZ(offset[5]),
+                      KDL::Vector(offset[0], offset[1], offset[2]));
+}
+
+void KinematicsFromURDF::compute_transforms(bool all,
+                                            bool camera_offset_changed)
+{
+    // single pass from the root to the leaves. Parents precede their
+    // children, so the parent frame and its dirty flag are always up to date.
+    if (all && use_generated_kinematics_)
+    {
+        compute_generated_transforms();
+    }
+    else
+    {
+        for (size_t i = 0; i < segments_.size(); ++i)
+        {
+            const int joint_index = segment_joint_indices_[i];
+            const int parent = segment_parents_[i];
+
+            segment_dirty_[i] =
+                all || (joint_index >= 0 && joint_changed_[joint_index]) ||
+                (parent >= 0 && segment_dirty_[parent]);
+            if (!segment_dirty_[i]) continue;
+
+            const double q = joint_index >= 0 ? jnt_array_(joint_index) : 0.0;
+            recomputed_link_count_++;
+
+            if (parent < 0)
+            {
+                segment_frames_[i] = segments_[i].pose(q);
+            }
+            else
+            {
+                segment_frames_[i] =
+                    segment_frames_[parent] * segments_[i].pose(q);
+            }
+        }
+    }
+
+    // get the transform from base to camera including the camera offset. If
+    // it changed, all link frames relative to the camera change as well.
+    const bool camera_dirty =
+        all || camera_offset_changed ||
+        (camera_segment_ >= 0 && segment_dirty_[camera_segment_]);
+    if (camera_dirty)
     {
-        if (std::find(mesh_names_.begin(),
-                      mesh_names_.end(),
-                      seg_it->second.segment.getName()) != mesh_names_.end())
+        const KDL::Frame camera = camera_segment_ >= 0
+                                      ? segment_frames_[camera_segment_]
+                                      : KDL::Frame::Identity();
+        cam_frame_ = (camera * camera_offset_frame_).Inverse();
+    }
+
+    for (size_t i = 0; i < mesh_segments_.size(); ++i)
+    {
+        if (camera_dirty || segment_dirty_[mesh_segments_[i]])
         {
-            KDL::Frame frame;
-            if (tree_solver_->JntToCart(
-                    jnt_array_, frame, seg_it->second.segment.getName()) < 0)
-                ROS_ERROR("TreeSolver returned an error for link %s",
-                          seg_it->second.segment.getName().c_str());
-            frame_map_[seg_it->second.segment.getName()] = cam_frame_ * frame;
+            link_frames_[i] = cam_frame_ * segment_frames_[mesh_segments_[i]];
+            store_link_pose(link_frames_[i], link_poses_[i]);
         }
     }
 }
 
+void KinematicsFromURDF::store_link_pose(const KDL::Frame& frame,
+                                         LinkPose& pose)
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        pose.affine[r * 4] = frame.M.data[r * 3];
+        pose.affine[r * 4 + 1] = frame.M.data[r * 3 + 1];
+        pose.affine[r * 4 + 2] = frame.M.data[r * 3 + 2];
+        pose.affine[r * 4 + 3] = frame.p(r);
+    }
+
+    double x, y, z, w;
+    frame.M.GetQuaternion(x, y, z, w);
+    pose.quaternion[0] = x;
+    pose.quaternion[1] = y;
+    pose.quaternion[2] = z;
+    pose.quaternion[3] = w;
+}
+
+void KinematicsFromURDF::compute_generated_transforms()
+{
+#ifdef DBRT_GENERATED_KINEMATICS
+    dbrt::generated_kinematics::compute_segment_frames(
+        jnt_array_.data.data(), generated_frames_.data());
+
+    for (size_t i = 0; i < segments_.size(); ++i)
+    {
+        const double* f = &generated_frames_[i * frame_size];
+        segment_frames_[i] = KDL::Frame(
+            KDL::Rotation(f[0], f[1], f[2], f[3], f[4], f[5], f[6], f[7], f[8]),
+            KDL::Vector(f[9], f[10], f[11]));
+        segment_dirty_[i] = true;
+    }
+    recomputed_link_count_ += segments_.size();
+#endif
+}
+
+/**
+ * \brief Stores the twist of a joint, given relative to the root, as the
+ *        column of a link Jacobian in the camera frame
+ */
+static void store_twist(const KDL::Rotation& to_camera,
+                        const KDL::Vector& linear,
+                        const KDL::Vector& angular,
+                        KinematicsFromURDF::LinkJacobian& jacobian,
+                        int column)
+{
+    const KDL::Vector v = to_camera * linear;
+    const KDL::Vector w = to_camera * angular;
+    jacobian.col(column) << v.x(), v.y(), v.z(), w.x(), w.y(), w.z();
+}
+
+void KinematicsFromURDF::add_joint_twist(int segment,
+                                         double sign,
+                                         const KDL::Vector& position,
+                                         const KDL::Rotation& to_camera,
+                                         LinkJacobian& jacobian) const
+{
+    const int joint = segment_joint_indices_[segment];
+    if (joint < 0) return;
+
+    const KDL::Vector axis = sign * joint_axes_[segment];
+    if (segment_models_[segment].type == SegmentModel::Rotational)
+    {
+        store_twist(to_camera,
+                    axis * (position - joint_points_[segment]),
+                    axis,
+                    jacobian,
+                    joint);
+    }
+    else
+    {
+        store_twist(to_camera, axis, KDL::Vector::Zero(), jacobian, joint);
+    }
+}
+
+void KinematicsFromURDF::compute_link_jacobians(
+    std::vector<LinkJacobian>& jacobians)
+{
+    const int segment_count = segments_.size();
+    joint_axes_.resize(segment_count);
+    joint_points_.resize(segment_count);
+    camera_path_.assign(segment_count, false);
+    link_path_.assign(segment_count, false);
+
+    // the motion of a joint is a rotation about or a translation along its
+    // axis in the frame of the parent tip times the joint origin
+    for (int k = 0; k < segment_count; ++k)
+    {
+        if (segment_joint_indices_[k] < 0) continue;
+
+        const SegmentModel& model = segment_models_[k];
+        const KDL::Frame joint_frame =
+            segment_parents_[k] < 0
+                ? model.origin
+                : segment_frames_[segment_parents_[k]] * model.origin;
+        joint_axes_[k] = joint_frame.M * (model.scale * model.axis);
+        joint_points_[k] = joint_frame.p;
+    }
+
+    for (int k = camera_segment_; k >= 0; k = segment_parents_[k])
+    {
+        camera_path_[k] = true;
+    }
+
+    const KDL::Frame camera_segment_frame =
+        camera_segment_ >= 0 ? segment_frames_[camera_segment_]
+                             : KDL::Frame::Identity();
+    const KDL::Vector camera_position =
+        (camera_segment_frame * camera_offset_frame_).p;
+    const KDL::Rotation& to_camera = cam_frame_.M;
+
+    // axes of x, y, z, pitch, yaw and roll of the camera offset relative to
+    // the root. The offset rotation is RotX(pitch) * RotY(yaw) * RotZ(roll).
+    KDL::Vector offset_axes[camera_offset_dim];
+    if (use_camera_offset_)
+    {
+        const KDL::Rotation& R = camera_segment_frame.M;
+        const KDL::Rotation pitch = KDL::Rotation::RotX(camera_offset_(3));
+        const KDL::Rotation yaw = KDL::Rotation::RotY(camera_offset_(4));
+        offset_axes[0] = R.UnitX();
+        offset_axes[1] = R.UnitY();
+        offset_axes[2] = R.UnitZ();
+        offset_axes[3] = R.UnitX();
+        offset_axes[4] = R * pitch.UnitY();
+        offset_axes[5] = R * (pitch * yaw).UnitZ();
+    }
+
+    jacobians.resize(mesh_segments_.size());
+    for (size_t i = 0; i < mesh_segments_.size(); ++i)
+    {
+        LinkJacobian& jacobian = jacobians[i];
+        jacobian.setZero(6, num_joints());
+
+        const int link_segment = mesh_segments_[i];
+        const KDL::Vector& position = segment_frames_[link_segment].p;
+
+        for (int k = link_segment; k >= 0; k = segment_parents_[k])
+        {
+            link_path_[k] = true;
+            if (!camera_path_[k])
+            {
+                add_joint_twist(k, 1.0, position, to_camera, jacobian);
+            }
+        }
+
+        for (int k = camera_segment_; k >= 0; k = segment_parents_[k])
+        {
+            if (!link_path_[k])
+            {
+                add_joint_twist(k, -1.0, position, to_camera, jacobian);
+            }
+        }
+
+        for (int k = link_segment; k >= 0; k = segment_parents_[k])
+        {
+            link_path_[k] = false;
+        }
+
+        // the camera offset moves the camera only
+        if (!use_camera_offset_) continue;
+        for (int d = 0; d < camera_offset_dim; ++d)
+        {
+            const KDL::Vector axis = -1.0 * offset_axes[d];
+            const int column = camera_offset_joint_indices_[d];
+            if (d < 3)
+            {
+                store_twist(to_camera,
+                            axis,
+                            KDL::Vector::Zero(),
+                            jacobian,
+                            column);
+            }
+            else
+            {
+                store_twist(to_camera,
+                            axis * (position - camera_position),
+                            axis,
+                            jacobian,
+                            column);
+            }
+        }
+    }
+}
+
+std::size_t KinematicsFromURDF::recomputed_link_count() const
+{
+    return recomputed_link_count_;
+}
+
+void KinematicsFromURDF::reset_recomputed_link_count()
+{
+    recomputed_link_count_ = 0;
+}
+
 Eigen::VectorXd KinematicsFromURDF::get_link_position(int index)
 {
     Eigen::VectorXd pos(3);
 
-    KDL::Frame& frame = frame_map_[mesh_names_[index]];
+    const KDL::Frame& frame = link_frames_[index];
     pos << frame.p.x(), frame.p.y(), frame.p.z();
 
     return pos;
@@ -327,7 +1020,7 @@ void KinematicsFromURDF::print_links()
 Eigen::Quaternion<double> KinematicsFromURDF::get_link_orientation(int index)
 {
     Eigen::Quaternion<double> quat;
-    frame_map_[mesh_names_[index]].M.GetQuaternion(
+    link_frames_[index].M.GetQuaternion(
         quat.x(), quat.y(), quat.z(), quat.w());
 
     return quat;
@@ -342,49 +1035,65 @@ dbot::PoseVector KinematicsFromURDF::get_link_pose(int index)
     return pose_vector;
 }
 
+const std::vector<KinematicsFromURDF::LinkPose>&
+KinematicsFromURDF::link_poses() const
+{
+    return link_poses_;
+}
+
 Eigen::VectorXd KinematicsFromURDF::sensor_msg_to_eigen(
     const sensor_msgs::JointState& sensor_msg)
 {
-    sensor_msgs::JointState joint_state = sensor_msg;
-
-    if (use_camera_offset_)
+    Eigen::VectorXd eigen = Eigen::VectorXd::Zero(num_joints());
+    if (!sensor_msg_to_eigen(sensor_msg, eigen))
     {
-        joint_state.name.push_back(cam_frame_name_ + "_X_JOINT");
-        joint_state.name.push_back(cam_frame_name_ + "_Y_JOINT");
-        joint_state.name.push_back(cam_frame_name_ + "_Z_JOINT");
-        joint_state.name.push_back(cam_frame_name_ + "_ROLL_JOINT");
-        joint_state.name.push_back(cam_frame_name_ + "_PITCH_JOINT");
-        joint_state.name.push_back(cam_frame_name_ + "_YAW_JOINT");
-
-        joint_state.position.push_back(0);
-        joint_state.position.push_back(0);
-        joint_state.position.push_back(0);
-        joint_state.position.push_back(0);
-        joint_state.position.push_back(0);
-        joint_state.position.push_back(0);
+        ROS_ERROR_THROTTLE(1.0,
+                           "Joint state message does not contain all robot "
+                           "joints. The missing joints are set to zero.");
     }
 
-    check_size(joint_state.position.size());
+    return eigen;
+}
+
+bool KinematicsFromURDF::sensor_msg_to_eigen(
+    const sensor_msgs::JointState& sensor_msg,
+    Eigen::VectorXd& eigen)
+{
+    std::lock_guard<std::mutex> lock(joint_layouts_mutex_);
+    return sensor_msg_to_eigen(sensor_msg, eigen, joint_layouts_);
+}
+
+bool KinematicsFromURDF::sensor_msg_to_eigen(
+    const sensor_msgs::JointState& sensor_msg,
+    Eigen::VectorXd& eigen,
+    JointLayoutCache& layouts) const
+{
+    const int joint_count = joint_map_.size();
+    if (eigen.size() != joint_count) eigen.setZero(joint_count);
 
-    Eigen::VectorXd eigen(joint_state.position.size());
+    const JointLayoutCache::Layout& layout =
+        joint_layout(sensor_msg.name, layouts);
 
-    for (size_t i = 0; i < joint_state.position.size(); i++)
+    const size_t count =
+        std::min(layout.permutation.size(), sensor_msg.position.size());
+    for (size_t i = 0; i < count; i++)
     {
-        int joint_index = name_to_index(joint_state.name[i]);
-
+        const int joint_index = layout.permutation[i];
         if (joint_index >= 0)
         {
-            eigen(joint_index) = joint_state.position[i];
-        }
-        else
-        {
-            ROS_ERROR("i: %d, No joint index for %s",
-                      int(i),
-                      joint_state.name[i].c_str());
+            eigen(joint_index) = sensor_msg.position[i];
         }
     }
 
-    return eigen;
+    // the camera offset is not measured
+    for (int joint_index : camera_offset_joint_indices_)
+    {
+        eigen(joint_index) = 0;
+    }
+
+    return layout.required_positions >= 0 &&
+           sensor_msg.position.size() >=
+               std::size_t(layout.required_positions);
 }
 
 std::vector<int> KinematicsFromURDF::get_joint_order(
@@ -404,12 +1113,83 @@ KDL::Tree KinematicsFromURDF::get_tree()
     return kin_tree_;
 }
 
-int KinematicsFromURDF::name_to_index(const std::string& name)
+auto KinematicsFromURDF::joint_layout(const std::vector<std::string>& names,
+                                      JointLayoutCache& layouts) const
+    -> const JointLayoutCache::Layout&
 {
-    for (unsigned int i = 0; i < joint_map_.size(); ++i)
+    // comparing the names reads them once like hashing would, but is exact.
+    // It does not allocate.
+    for (const auto& layout : layouts.layouts_)
+    {
+        if (names == layout.names) return layout;
+    }
+
+    // a new layout, build its permutation in place of the oldest one
+    if (layouts.layouts_.size() < JointLayoutCache::capacity)
     {
-        if (joint_map_[i] == name) return i;
+        layouts.layouts_.emplace_back();
+        layouts.next_ = layouts.layouts_.size() - 1;
     }
+    JointLayoutCache::Layout& layout = layouts.layouts_[layouts.next_];
+    layouts.next_ = (layouts.next_ + 1) % JointLayoutCache::capacity;
+
+    const int robot_joint_count = num_robot_joints();
+    std::vector<bool> covered(robot_joint_count, false);
+    int covered_count = 0;
+    int unknown_count = 0;
+    int required_positions = 0;
+    layout.names = names;
+    layout.permutation.resize(names.size());
+    for (size_t i = 0; i < names.size(); i++)
+    {
+        int joint_index = find_joint_index(names[i]);
+        if (joint_index >= robot_joint_count) joint_index = -1;
+        layout.permutation[i] = joint_index;
+
+        if (joint_index < 0)
+        {
+            ROS_ERROR_THROTTLE(1.0,
+                               "No joint index for %s. Ignoring this joint.",
+                               names[i].c_str());
+            unknown_count++;
+            continue;
+        }
+
+        if (!covered[joint_index])
+        {
+            covered[joint_index] = true;
+            covered_count++;
+        }
+        required_positions = i + 1;
+    }
+
+    layout.required_positions =
+        covered_count == robot_joint_count ? required_positions : -1;
+    if (covered_count != robot_joint_count)
+    {
+        ROS_ERROR_THROTTLE(1.0,
+                           "Joint state layout contains %d of %d robot "
+                           "joints and %d unknown joints.",
+                           covered_count,
+                           robot_joint_count,
+                           unknown_count);
+    }
+
+    return layout;
+}
+
+int KinematicsFromURDF::find_joint_index(const std::string& name) const
+{
+    auto it = joint_index_map_.find(name);
+    if (it == joint_index_map_.end()) return -1;
+
+    return it->second;
+}
+
+int KinematicsFromURDF::name_to_index(const std::string& name)
+{
+    int index = find_joint_index(name);
+    if (index >= 0) return index;
 
     std::cout << "could not find joint with name " << name << std::endl;
     exit(-1);
@@ -423,9 +1203,22 @@ std::string KinematicsFromURDF::get_link_name(int idx)
 
 int KinematicsFromURDF::num_joints()
 {
-    int n_joints = kin_tree_.getNrOfJoints();
+    return joint_map_.size();
+}
 
-    return n_joints;
+int KinematicsFromURDF::num_robot_joints() const
+{
+    return kin_tree_.getNrOfJoints();
+}
+
+bool KinematicsFromURDF::use_camera_offset() const
+{
+    return use_camera_offset_;
+}
+
+const std::vector<int>& KinematicsFromURDF::camera_offset_joint_indices() const
+{
+    return camera_offset_joint_indices_;
 }
 
 int KinematicsFromURDF::num_links()
@@ -433,11 +1226,79 @@ int KinematicsFromURDF::num_links()
     return mesh_names_.size();
 }
 
+std::uint64_t KinematicsFromURDF::model_version() const
+{
+    return model_version_;
+}
+
 const std::vector<std::string>& KinematicsFromURDF::get_joint_map() const
 {
     return joint_map_;
 }
 
+int KinematicsFromURDF::num_segments() const
+{
+    return segments_.size();
+}
+
+auto KinematicsFromURDF::segment_models() const
+    -> const std::vector<SegmentModel>&
+{
+    return segment_models_;
+}
+
+const std::vector<int>& KinematicsFromURDF::segment_parents() const
+{
+    return segment_parents_;
+}
+
+const std::vector<int>& KinematicsFromURDF::segment_joint_indices() const
+{
+    return segment_joint_indices_;
+}
+
+std::uint64_t KinematicsFromURDF::model_fingerprint() const
+{
+    // FNV-1a over the raw bytes of the flat model
+    std::uint64_t hash = 14695981039346656037ull;
+    auto hash_bytes = [&hash](const void* data, std::size_t size)
+    {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    auto hash_frame = [&hash_bytes](const KDL::Frame& frame)
+    {
+        hash_bytes(frame.M.data, sizeof(frame.M.data));
+        hash_bytes(frame.p.data, sizeof(frame.p.data));
+    };
+
+    const int joint_count = kin_tree_.getNrOfJoints();
+    hash_bytes(&joint_count, sizeof(joint_count));
+    for (size_t i = 0; i < segment_models_.size(); ++i)
+    {
+        const SegmentModel& model = segment_models_[i];
+        const int type = model.type;
+
+        hash_bytes(&segment_parents_[i], sizeof(int));
+        hash_bytes(&segment_joint_indices_[i], sizeof(int));
+        hash_bytes(&type, sizeof(type));
+        hash_frame(model.origin);
+        hash_frame(model.tip);
+        hash_bytes(model.axis.data, sizeof(model.axis.data));
+        hash_bytes(&model.scale, sizeof(model.scale));
+    }
+
+    return hash;
+}
+
+bool KinematicsFromURDF::uses_generated_kinematics() const
+{
+    return use_generated_kinematics_;
+}
+
 std::string KinematicsFromURDF::get_root_frame_id()
 {
     return kin_tree_.getRootSegment()->first;
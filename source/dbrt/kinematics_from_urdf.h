@@ -23,21 +23,130 @@
 
 #include <Eigen/Core>
 #include <Eigen/Geometry>
+#include <atomic>
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/shared_ptr.hpp>
 #include <dbot/pose/pose_vector.h>
 #include <dbrt/part_mesh_model.h>
-#include <kdl/treefksolverpos_recursive.hpp>
+#include <kdl/frames.hpp>
+#include <kdl/tree.hpp>
 #include <kdl_parser/kdl_parser.hpp>
+#include <cstdint>
 #include <list>
+#include <memory>
+#include <mutex>
 #include <ros/ros.h>
 #include <sensor_msgs/JointState.h>
+#include <unordered_map>
 #include <urdf/model.h>
 #include <vector>
 
 class KinematicsFromURDF
 {
 public:
+    typedef Eigen::
+        Matrix<double, Eigen::Dynamic, Eigen::Dynamic, Eigen::RowMajor>
+            BatchMatrix;
+
+    /**
+     * \brief Jacobian of a link pose relative to the camera. Column j holds
+     *        the linear velocity (rows 0 to 2) and the angular velocity
+     *        (rows 3 to 5) of the link in the camera frame for a unit
+     *        velocity of joint state entry j.
+     */
+    typedef Eigen::Matrix<double, 6, Eigen::Dynamic> LinkJacobian;
+
+    /**
+     * \brief Link poses of many joint states in struct-of-arrays layout.
+     *
+     * Entry (i, n) of each matrix belongs to link i of joint state n, i.e.
+     * the values of one link are contiguous across all joint states. The
+     * poses are relative to the camera like get_link_pose().
+     */
+    struct LinkPoseBatch
+    {
+        BatchMatrix px, py, pz;
+        BatchMatrix qx, qy, qz, qw;
+
+        // segment frames and inverse camera frames of all joint states,
+        // reused across calls
+        std::vector<double> segment_frames;
+        std::vector<double> camera_frames;
+    };
+
+    /**
+     * \brief Decomposition of a segment pose into
+     *        pose(q) = origin * motion(q) * tip where the motion is a rotation
+     *        about or a translation along axis by scale * q
+     */
+    struct SegmentModel
+    {
+        enum Type
+        {
+            Fixed,
+            Rotational,
+            Translational
+        };
+
+        Type type;
+        KDL::Frame origin;
+        KDL::Frame tip;
+        KDL::Vector axis;
+        double scale;
+    };
+
+    /**
+     * \brief Pose of a link relative to the camera in the layout consumed by
+     *        the renderers
+     */
+    struct LinkPose
+    {
+        // row-major 3x4 affine transform [R | p]
+        float affine[12];
+        // orientation quaternion x, y, z, w
+        float quaternion[4];
+    };
+
+    enum
+    {
+        // x, y, z, pitch, yaw and roll of the camera offset
+        camera_offset_dim = 6
+    };
+
+    /**
+     * \brief Joint permutations of the joint state name layouts seen last,
+     *        e.g. of several publishers of different joint subsets.
+     *
+     * Up to capacity layouts are kept and a new layout replaces the oldest
+     * one. A cache is not thread-safe, every converting thread owns one.
+     */
+    class JointLayoutCache
+    {
+    public:
+        enum
+        {
+            capacity = 4
+        };
+
+        JointLayoutCache() : next_(0) {}
+
+    private:
+        friend class KinematicsFromURDF;
+
+        struct Layout
+        {
+            std::vector<std::string> names;
+            // state index of each message entry, -1 for unknown names
+            std::vector<int> permutation;
+            // number of message positions needed to cover all robot joints,
+            // or -1 if the names do not cover all robot joints
+            int required_positions;
+        };
+
+        std::vector<Layout> layouts_;
+        std::size_t next_;
+    };
+
     KinematicsFromURDF(const std::string& robot_description,
                        const std::string& robot_description_package_path,
                        const std::string& rendering_root_left,
@@ -47,44 +156,209 @@ public:
 
     ~KinematicsFromURDF();
 
+    /**
+     * \brief Creates an independent kinematics context of the same robot.
+     *
+     * The clone shares the URDF links with this instance and has its own
+     * joint state and frame buffers, so clones can compute poses on
+     * different threads without locking. The part meshes have to be loaded
+     * before cloning. Cloning is safe against a concurrent
+     * get_part_meshes(), but not against set_joint_angles() on this
+     * instance.
+     */
+    std::shared_ptr<KinematicsFromURDF> clone() const;
+
     /// mutators ***************************************************************
+    /**
+     * \brief Sets the joint state of num_joints() entries. If the camera
+     *        offset is estimated, the last camera_offset_dim entries are the
+     *        camera offset.
+     */
     void set_joint_angles(const Eigen::VectorXd& joint_state);
 
+    /**
+     * \brief Publishes the offset x, y, z, pitch, yaw, roll of the camera
+     *        relative to the camera frame of the robot description. The
+     *        offset is a transform applied to the camera frame, it does not
+     *        add joints to the kinematic tree.
+     *
+     * The published offset is shared with all clones and may be set from any
+     * thread. It takes effect with the next set_joint_angles() of joint
+     * states which do not carry the camera offset themselves.
+     */
+    void set_camera_offset(const Eigen::VectorXd& offset);
+
     /// accessors **************************************************************
+    /**
+     * \brief Total number of link frames recomputed by set_joint_angles().
+     *        Only the links below joints whose angle changed are recomputed.
+     */
+    std::size_t recomputed_link_count() const;
+    void reset_recomputed_link_count();
+
     Eigen::VectorXd get_link_position(int index);
     Eigen::Quaternion<double> get_link_orientation(int index);
     dbot::PoseVector get_link_pose(int index);
 
+    /**
+     * \brief Link poses of the last set_joint_angles() stored contiguously by
+     *        mesh index. Reading them involves no conversion, so this is the
+     *        access meant for render loops.
+     */
+    const std::vector<LinkPose>& link_poses() const;
+
+    /**
+     * \brief Computes the link poses of many joint states in one call. Each
+     *        column of joint_states is one joint state with num_joints()
+     *        rows.
+     *
+     * The computation is vectorized across the joint states and does not
+     * touch the cached frames of set_joint_angles(). If the camera offset is
+     * not part of the state, the offset last published through
+     * set_camera_offset() is used. The function may therefore be called
+     * concurrently with set_joint_angles() and set_camera_offset() once the
+     * part meshes have been loaded.
+     */
+    void compute_link_poses(const BatchMatrix& joint_states,
+                            LinkPoseBatch& poses) const;
+
+    /**
+     * \brief Computes the Jacobians of all link poses, indexed by mesh index,
+     *        at the joint state of the last set_joint_angles().
+     *
+     * The Jacobians are assembled from the joint axes of the segment frames
+     * of that forward kinematics pass, no further pass is run. Joints above
+     * a link move it, joints above the camera move it the opposite way and
+     * joints above both do not change the pose relative to the camera.
+     */
+    void compute_link_jacobians(std::vector<LinkJacobian>& jacobians);
+
     std::vector<int> get_joint_order(const sensor_msgs::JointState& state);
+
+    /**
+     * \brief Creates the part meshes and rebuilds the mesh index tables. Not
+     *        safe to call while any other thread uses this instance.
+     */
     void get_part_meshes(
         std::vector<boost::shared_ptr<PartMeshModel>>& part_meshes);
     KDL::Tree get_tree();
 
+    /**
+     * \brief Dimension of the joint state, i.e. the robot joints followed by
+     *        the camera offset if it is estimated
+     */
     int num_joints();
+    // number of joints of the kinematic tree
+    int num_robot_joints() const;
     int num_links();
+
+    /**
+     * \brief Version of the robot model and its mesh tables. It is unique
+     *        across all instances and changes with every get_part_meshes()
+     *        call. A clone carries the version of the model it was cloned
+     *        from. May be read from any thread.
+     */
+    std::uint64_t model_version() const;
+
+    bool use_camera_offset() const;
+    // state indices of x, y, z, pitch, yaw and roll of the camera offset
+    const std::vector<int>& camera_offset_joint_indices() const;
+    // camera offset last published through set_camera_offset()
+    Eigen::VectorXd camera_offset() const;
+    // number of set_camera_offset() calls, 0 if no offset has been published
+    std::uint64_t camera_offset_version() const;
     std::string get_link_name(int idx);
     const std::vector<std::string>& get_joint_map() const;
     std::string get_root_frame_id();
 
     /// convenience ************************************************************
+    /**
+     * \brief Converts the joint state message. Robot joints missing in the
+     *        message are reported and set to zero.
+     */
     Eigen::VectorXd sensor_msg_to_eigen(const sensor_msgs::JointState& angles);
+    /**
+     * \brief Converts the joint state message into the given vector without
+     *        copying the message. The vector is only resized if it does not
+     *        have num_joints() entries already.
+     *
+     * Returns false if the message does not contain every robot joint. The
+     * entries of the missing joints keep their previous values then, so the
+     * vector must not be used as a measurement.
+     *
+     * The mapping from message entries to state indices is cached for the
+     * last JointLayoutCache::capacity name layouts. Unknown joint names are
+     * reported when a layout is cached and ignored.
+     */
+    bool sensor_msg_to_eigen(const sensor_msgs::JointState& angles,
+                             Eigen::VectorXd& eigen);
+
+    /**
+     * \brief Same as above with a layout cache owned by the caller. Takes no
+     *        lock and does not allocate once the layouts of the messages are
+     *        cached.
+     */
+    bool sensor_msg_to_eigen(const sensor_msgs::JointState& angles,
+                             Eigen::VectorXd& eigen,
+                             JointLayoutCache& layouts) const;
     void print_joints();
     void print_links();
 
-    // get the joint index in state array
+    // get the joint index in state array. Exits if the joint does not exist.
     int name_to_index(const std::string& name);
 
+    // get the joint index in state array or -1 if the joint does not exist
+    int find_joint_index(const std::string& name) const;
+
     const std::string& camera_frame_id() const { return cam_frame_name_; }
 
+    /// flat kinematic model ***************************************************
+    /**
+     * \brief Segments in topological order, i.e. every segment comes after
+     *        its parent. The root segment has index 0 and parent -1.
+     */
+    int num_segments() const;
+    const std::vector<SegmentModel>& segment_models() const;
+    const std::vector<int>& segment_parents() const;
+    // joint state index of each segment or -1 for fixed segments
+    const std::vector<int>& segment_joint_indices() const;
+
+    /**
+     * \brief Hash of the flat kinematic model. Generated kinematics are only
+     *        used if they were generated from a model with the same
+     *        fingerprint.
+     */
+    std::uint64_t model_fingerprint() const;
+
+    /**
+     * \brief Returns true if the full forward kinematics pass uses the code
+     *        generated at build time (DBRT_GENERATED_KINEMATICS)
+     */
+    bool uses_generated_kinematics() const;
+
 private:
-    void rename_camera_frame(const std::string& camera_frame,
-                             urdf::Model& urdf);
-    void inject_offset_joints_and_links(const std::string& camera_frame,
-                                        urdf::Model& urdf);
+    KinematicsFromURDF(const KinematicsFromURDF& other);
+    KinematicsFromURDF& operator=(const KinematicsFromURDF&) = delete;
 
     void check_size(int size);
 
-    void compute_transforms();
+    bool update_camera_offset(const Eigen::Ref<const Eigen::VectorXd>& offset);
+    bool apply_published_camera_offset();
+    static KDL::Frame camera_offset_to_frame(const double* offset);
+
+    const JointLayoutCache::Layout& joint_layout(
+        const std::vector<std::string>& names,
+        JointLayoutCache& layouts) const;
+
+    void build_segment_list();
+    void compute_transforms(bool all, bool camera_offset_changed);
+    void compute_generated_transforms();
+    static void store_link_pose(const KDL::Frame& frame, LinkPose& pose);
+    void add_joint_twist(int segment,
+                         double sign,
+                         const KDL::Vector& position,
+                         const KDL::Rotation& to_camera,
+                         LinkJacobian& jacobian) const;
 
     // std::string tf_correction_root_;
     std::string description_path_;
@@ -96,16 +370,71 @@ private:
 
     // maps joint indices to joint names and joint limits
     std::vector<std::string> joint_map_;
+    // maps joint names to joint indices
+    std::unordered_map<std::string, int> joint_index_map_;
+
+    // joint state layouts of the sensor_msg_to_eigen() calls without a
+    // caller-owned cache
+    JointLayoutCache joint_layouts_;
+    std::mutex joint_layouts_mutex_;
 
     // maps mesh indices to link names
     std::vector<std::string> mesh_names_;
-    // maps link names to KDL frames
-    std::map<std::string, KDL::Frame> frame_map_;
+    // maps mesh indices to segment indices
+    std::vector<int> mesh_segments_;
+    // link frames relative to the camera, indexed by mesh index
+    std::vector<KDL::Frame> link_frames_;
+    // float copies of link_frames_ in renderer layout
+    std::vector<LinkPose> link_poses_;
 
     // KDL segment map connecting link segments to joints
     KDL::SegmentMap segment_map_;
-    // Forward kinematics solver
-    KDL::TreeFkSolverPos_recursive* tree_solver_;
+
+    // Flat kinematic tree in topological order, i.e. every segment comes after
+    // its parent. The root segment has index 0 and parent -1.
+    std::vector<KDL::Segment> segments_;
+    std::vector<int> segment_parents_;
+    // joint state index of each segment or -1 for fixed segments
+    std::vector<int> segment_joint_indices_;
+    // segment tip frames relative to the root
+    std::vector<KDL::Frame> segment_frames_;
+    // maps segment names to segment indices
+    std::unordered_map<std::string, int> segment_index_map_;
+    // index of the camera segment or -1
+    int camera_segment_;
+
+    std::vector<SegmentModel> segment_models_;
+
+    // number of values of a frame in struct-of-arrays layout: the row-major
+    // rotation followed by the translation
+    enum
+    {
+        frame_size = 12
+    };
+
+    static SegmentModel create_segment_model(const KDL::Segment& segment);
+    static void apply_motion_batch(const SegmentModel& model,
+                                   const double* q,
+                                   double* const f[frame_size],
+                                   int count);
+
+    // joint axes scaled by the joint scale and joint positions relative to
+    // the root, computed by compute_link_jacobians()
+    std::vector<KDL::Vector> joint_axes_;
+    std::vector<KDL::Vector> joint_points_;
+    // segments on the path from the camera and from a link to the root
+    std::vector<char> camera_path_;
+    std::vector<char> link_path_;
+
+    // set if the generated kinematics match this model
+    bool use_generated_kinematics_;
+    std::vector<double> generated_frames_;
+
+    // dirty tracking of the incremental forward kinematics
+    bool frames_valid_;
+    std::vector<char> joint_changed_;
+    std::vector<char> segment_dirty_;
+    std::size_t recomputed_link_count_;
 
     // KDL copy of the joint state
     KDL::JntArray jnt_array_;
@@ -117,5 +446,26 @@ private:
     std::string rendering_root_left_, rendering_root_right_;
 
     bool use_camera_offset_;
-    dbot::PoseVector camera_offset_;
+    // camera offset x, y, z, pitch, yaw, roll and its transform which is
+    // applied to the camera segment frame
+    Eigen::VectorXd camera_offset_;
+    KDL::Frame camera_offset_frame_;
+    // state indices of the camera offset values
+    std::vector<int> camera_offset_joint_indices_;
+
+    // camera offset published through set_camera_offset(), shared by all
+    // clones, and the version of it which has been applied here
+    struct PublishedCameraOffset
+    {
+        std::mutex mutex;
+        Eigen::VectorXd offset;
+        std::atomic<std::uint64_t> version;
+    };
+    std::shared_ptr<PublishedCameraOffset> published_camera_offset_;
+    std::uint64_t camera_offset_version_;
+
+    // serializes clone() and the mesh table rebuild of get_part_meshes()
+    mutable std::mutex model_mutex_;
+    // changed under model_mutex_
+    std::atomic<std::uint64_t> model_version_;
 };
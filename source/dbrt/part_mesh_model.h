@@ -48,7 +48,81 @@
 #include "assimp/scene.h"
 #endif
 
+#include <algorithm>
 #include <boost/filesystem.hpp>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+/**
+ * \brief Triangle mesh in flat buffers as consumed by the renderers. The
+ *        vertices are interleaved x, y, z floats and every 3 indices form a
+ *        triangle.
+ */
+struct PartMeshBuffers
+{
+    std::vector<float> vertices;
+    std::vector<std::uint32_t> indices;
+
+    // bounding sphere of the vertices, see update_bounding_sphere()
+    Eigen::Vector3f sphere_center = Eigen::Vector3f::Zero();
+    float sphere_radius = 0;
+
+    std::size_t vertex_count() const { return vertices.size() / 3; }
+    std::size_t triangle_count() const { return indices.size() / 3; }
+
+    /**
+     * \brief Sets the bounding sphere to the sphere around the center of the
+     *        bounding box which contains all vertices
+     */
+    void update_bounding_sphere()
+    {
+        sphere_center.setZero();
+        sphere_radius = 0;
+        if (vertices.empty()) return;
+
+        typedef Eigen::Map<const Eigen::Vector3f> Vertex;
+        Eigen::Vector3f min = Vertex(&vertices[0]);
+        Eigen::Vector3f max = min;
+        for (std::size_t v = 1; v < vertex_count(); ++v)
+        {
+            min = min.cwiseMin(Vertex(&vertices[3 * v]));
+            max = max.cwiseMax(Vertex(&vertices[3 * v]));
+        }
+
+        sphere_center = (min + max) / 2;
+        float squared_radius = 0;
+        for (std::size_t v = 0; v < vertex_count(); ++v)
+        {
+            squared_radius = std::max(
+                squared_radius,
+                (Vertex(&vertices[3 * v]) - sphere_center).squaredNorm());
+        }
+        sphere_radius = std::sqrt(squared_radius);
+    }
+
+    // conversions into the layout of dbot::ObjectModelLoader
+    std::vector<Eigen::Vector3d> vertex_vectors() const
+    {
+        std::vector<Eigen::Vector3d> result(vertex_count());
+        for (std::size_t v = 0; v < result.size(); ++v)
+        {
+            result[v] = Eigen::Map<const Eigen::Vector3f>(&vertices[3 * v])
+                            .cast<double>();
+        }
+        return result;
+    }
+
+    std::vector<std::vector<int>> triangle_vectors() const
+    {
+        std::vector<std::vector<int>> result(triangle_count());
+        for (std::size_t t = 0; t < result.size(); ++t)
+        {
+            result[t].assign(&indices[3 * t], &indices[3 * t] + 3);
+        }
+        return result;
+    }
+};
 
 class PartMeshModel
 {
@@ -59,6 +133,8 @@ public:
                   bool collision)
         : proper_(false),
           link_(p_link),
+          loaded_(false),
+          numFaces_(0),
           name_(p_link->name),
           vertices_(new std::vector<Eigen::Vector3d>),
           indices_(new std::vector<std::vector<int>>)
@@ -104,10 +180,8 @@ public:
                         exit(-1);
                     }
 
-                    scene_ =
-                        aiImportFile(filename.c_str(),
-                                     aiProcessPreset_TargetRealtime_Quality);
-                    numFaces_ = scene_->mMeshes[0]->mNumFaces;
+                    // the mesh is imported by load()
+                    path_ = filename;
 
                     original_transform_.linear() =
                         Eigen::Quaterniond(link_->collision->origin.rotation.w,
@@ -163,10 +237,8 @@ public:
                         exit(-1);
                     }
 
-                    scene_ =
-                        aiImportFile(filename.c_str(),
-                                     aiProcessPreset_TargetRealtime_Quality);
-                    numFaces_ = scene_->mMeshes[0]->mNumFaces;
+                    // the mesh is imported by load()
+                    path_ = filename;
 
                     original_transform_.linear() =
                         Eigen::Quaterniond(link_->visual->origin.rotation.w,
@@ -187,26 +259,57 @@ public:
 
     boost::shared_ptr<std::vector<Eigen::Vector3d>> get_vertices()
     {
-        const struct aiMesh* mesh = scene_->mMeshes[0];
+        load();
+        *vertices_ = buffers_.vertex_vectors();
+        return vertices_;
+    }
+
+    boost::shared_ptr<std::vector<std::vector<int>>> get_indices()
+    {
+        load();
+        *indices_ = buffers_.triangle_vectors();
+        return indices_;
+    }
+
+    /**
+     * \brief Loads the mesh and moves its flat buffers out of the model. The
+     *        model is empty afterwards.
+     */
+    PartMeshBuffers take_buffers()
+    {
+        load();
+        return std::move(buffers_);
+    }
+
+    /**
+     * \brief Imports the mesh, extracts the transformed vertices and the
+     *        triangle indices and releases the imported scene. Does nothing
+     *        if the mesh has been loaded already.
+     */
+    void load()
+    {
+        if (loaded_) return;
+
+        const struct aiScene* scene =
+            aiImportFile(path_.c_str(), aiProcessPreset_TargetRealtime_Quality);
+        const struct aiMesh* mesh = scene->mMeshes[0];
+        numFaces_ = mesh->mNumFaces;
+
         unsigned num_vertices = mesh->mNumVertices;
-        vertices_->resize(num_vertices);
+        buffers_.vertices.resize(3 * num_vertices);
         for (unsigned v = 0; v < num_vertices; ++v)
         {
             Eigen::Vector3d point;
             point(0) = mesh->mVertices[v].x;
             point(1) = mesh->mVertices[v].y;
             point(2) = mesh->mVertices[v].z;
-            vertices_->at(v) = original_transform_ * point;
+            Eigen::Map<Eigen::Vector3f>(&buffers_.vertices[3 * v]) =
+                (original_transform_ * point).cast<float>();
         }
-        return vertices_;
-    }
 
-    boost::shared_ptr<std::vector<std::vector<int>>> get_indices()
-    {
-        const struct aiMesh* mesh = scene_->mMeshes[0];
         unsigned num_faces = mesh->mNumFaces;
         unsigned size_of_face = 3;  // assuming triangles, check!
-        indices_->resize(num_faces);
+        buffers_.indices.resize(size_of_face * num_faces);
         for (unsigned t = 0; t < num_faces; ++t)
         {
             const struct aiFace* face_ai = &mesh->mFaces[t];
@@ -218,29 +321,37 @@ public:
                 exit(-1);
             }
 
-            // fill a triangle with indices
-            std::vector<int> triangle(size_of_face);
             for (unsigned j = 0; j < face_ai->mNumIndices; j++)
-                triangle[j] = face_ai->mIndices[j];
-            indices_->at(t) = triangle;
+                buffers_.indices[size_of_face * t + j] = face_ai->mIndices[j];
         }
-        return indices_;
+
+        aiReleaseImport(scene);
+        buffers_.update_bounding_sphere();
+        loaded_ = true;
     }
 
     const std::string& get_name() { return name_; }
+
+    // resolved path of the mesh file
+    const std::string& get_mesh_path() const { return path_; }
+    // origin of the link geometry the vertices are transformed by
+    const Eigen::Affine3d& get_origin() const { return original_transform_; }
+
     bool proper_;
 
 private:
     const boost::shared_ptr<urdf::Link> link_;
-    const struct aiScene* scene_;
+    bool loaded_;
     unsigned numFaces_;
 
     boost::shared_ptr<std::vector<Eigen::Vector3d>> vertices_;
     boost::shared_ptr<std::vector<std::vector<int>>> indices_;
+    PartMeshBuffers buffers_;
 
     Eigen::Affine3d original_transform_;
 
     std::string name_;
 
     std::string filename_;
+    std::string path_;
 };
@@ -17,7 +17,7 @@
 #include <dbot/pose/euler_vector.h>
 #include <dbot/pose/rigid_bodies_state.h>
 #include <memory>
-#include <mutex>
+#include <utility>
 #include <vector>
 
 // TODO: THERE IS A PROBLEM HERE BECAUSE WE SHOULD NOT DEPEND ON THIS FILE,
@@ -41,35 +41,97 @@ public:
     {
     }
 
+    // copies start without link poses, moves take them along
+    RobotState(const RobotState& other) : Base(other) {}
+    RobotState(RobotState&& other)
+        : Base(other), link_pose_cache_(std::move(other.link_pose_cache_))
+    {
+        other.invalidate_link_poses();
+    }
+
     virtual ~RobotState() noexcept {}
-    using Base::operator=;
+
+    // assignments invalidate the link poses but keep their buffers
+    RobotState& operator=(const RobotState& other)
+    {
+        Base::operator=(other);
+        invalidate_link_poses();
+        return *this;
+    }
+
+    RobotState& operator=(RobotState&& other)
+    {
+        Base::operator=(other);
+        std::swap(link_pose_cache_, other.link_pose_cache_);
+        other.invalidate_link_poses();
+        return *this;
+    }
+
+    template <typename T>
+    RobotState& operator=(const Eigen::MatrixBase<T>& other)
+    {
+        Base::operator=(other);
+        invalidate_link_poses();
+        return *this;
+    }
+
+    template <typename T>
+    RobotState& operator+=(const Eigen::MatrixBase<T>& other)
+    {
+        Base::operator+=(other);
+        invalidate_link_poses();
+        return *this;
+    }
+
+    template <typename T>
+    RobotState& operator-=(const Eigen::MatrixBase<T>& other)
+    {
+        Base::operator-=(other);
+        invalidate_link_poses();
+        return *this;
+    }
+
+    /**
+     * \brief Marks the cached link poses as outdated. Eigen coefficient and
+     *        block writes cannot be intercepted, so they have to be followed
+     *        by this. Assignments invalidate the poses themselves.
+     */
+    void invalidate_link_poses() { link_pose_cache_.valid = false; }
 
 public:
     /// \todo this function should not be named count, this is confusing
     virtual int count() const
     {
-        CheckKinematics();
-        return kinematics_->num_links();
+        return thread_context().kinematics->num_links();
     }
 
     virtual int count_parts() const
     {
-        CheckKinematics();
-        return kinematics_->num_links();
+        return thread_context().kinematics->num_links();
     }
 
     /// todo: why does this return a pose velocity vector, but not
     /// set the velocity?
     virtual dbot::PoseVelocityVector component(int index) const
     {
-        std::lock_guard<std::mutex> lock(*kinematics_mutex_);
+        const LinkPoseCache& cache = link_pose_cache();
+
         dbot::PoseVelocityVector vector;
-        vector.position() = position(index);
-        vector.orientation() = euler_vector(index);
+        vector.position() = cache.link_positions[index];
+        vector.orientation() = cache.link_orientations[index];
 
         return vector;
     }
 
+    /**
+     * \brief Renderer-ready poses of all links relative to the camera,
+     *        indexed like component()
+     */
+    const std::vector<KinematicsFromURDF::LinkPose>& link_poses() const
+    {
+        return link_pose_cache().link_poses;
+    }
+
     // TODO: SHOULD THIS FUNCITON BE IN HERE?
     void GetJointState(std::map<std::string, double>& joint_positions) const
     {
@@ -90,25 +152,108 @@ public:
     //    }
 
 private:
+    /**
+     * \brief Link poses of a state and the kinematics versions they were
+     *        computed with
+     */
+    struct LinkPoseCache
+    {
+        bool valid = false;
+        std::uint64_t model_version = 0;
+        std::uint64_t camera_offset_version = 0;
+        std::vector<Vector> link_positions;
+        std::vector<dbot::EulerVector> link_orientations;
+        std::vector<KinematicsFromURDF::LinkPose> link_poses;
+    };
+
+    /**
+     * \brief Kinematics context of a thread
+     */
+    struct ThreadContext
+    {
+        // clone of kinematics_. Its model version identifies the instance
+        // and the mesh tables it was cloned from.
+        std::shared_ptr<KinematicsFromURDF> kinematics;
+    };
+
     virtual Vector position(const size_t& object_index = 0) const
     {
         assert(this->size() > 0);
-        CheckKinematics();
-        kinematics_->set_joint_angles(*this);
-
-        Vector v = kinematics_->get_link_position(object_index);
-        return v;
+        return link_pose_cache().link_positions[object_index];
     }
 
     virtual dbot::EulerVector euler_vector(const size_t& object_index = 0) const
     {
         assert(this->size() > 0);
+        return link_pose_cache().link_orientations[object_index];
+    }
+
+    /**
+     * \brief Link poses of this state, computed for all links at once on the
+     *        first query after a change of the state, of the part meshes or
+     *        of the published camera offset.
+     *
+     * The poses are stored with the state, so the per link queries of the
+     * renderers only compare two versions and the dirty flag. Like the state
+     * itself, a state must not be queried from several threads at once
+     * while its poses are outdated.
+     */
+    const LinkPoseCache& link_pose_cache() const
+    {
+        KinematicsFromURDF& kinematics = *thread_context().kinematics;
+
+        LinkPoseCache& cache = link_pose_cache_;
+        const std::uint64_t model_version = kinematics.model_version();
+        const std::uint64_t camera_offset_version =
+            kinematics_->camera_offset_version();
+        if (cache.valid && cache.model_version == model_version &&
+            cache.camera_offset_version == camera_offset_version)
+        {
+            return cache;
+        }
+
+        kinematics.set_joint_angles(*this);
+
+        const int link_count = kinematics.num_links();
+        cache.link_positions.resize(link_count);
+        cache.link_orientations.resize(link_count);
+        for (int i = 0; i < link_count; ++i)
+        {
+            cache.link_positions[i] = kinematics.get_link_position(i);
+            cache.link_orientations[i].quaternion(
+                kinematics.get_link_orientation(i));
+        }
+        cache.link_poses = kinematics.link_poses();
+
+        cache.valid = true;
+        cache.model_version = model_version;
+        cache.camera_offset_version = camera_offset_version;
+
+        return cache;
+    }
+
+    /**
+     * \brief Context of the calling thread. Each thread works on its own
+     *        clone of kinematics_, so pose queries of different threads
+     *        neither lock nor invalidate each other's frame cache.
+     */
+    ThreadContext& thread_context() const
+    {
         CheckKinematics();
-        kinematics_->set_joint_angles(*this);
 
-        dbot::EulerVector v;
-        v.quaternion(kinematics_->get_link_orientation(object_index));
-        return v;
+        thread_local ThreadContext context;
+
+        // clone again if kinematics_ has been replaced or has loaded its part
+        // meshes anew since. The model versions are unique across instances
+        // and read atomically, so this neither locks nor touches the
+        // reference count.
+        if (!context.kinematics || context.kinematics->model_version() !=
+                                       kinematics_->model_version())
+        {
+            context.kinematics = kinematics_->clone();
+        }
+
+        return context;
     }
 
     void CheckKinematics() const
@@ -121,15 +266,13 @@ private:
     }
 
 public:
-    static std::shared_ptr<std::mutex> kinematics_mutex_;
     static std::shared_ptr<KinematicsFromURDF> kinematics_;
+
+private:
+    mutable LinkPoseCache link_pose_cache_;
 };
 
 template <int JointCount, int BodyCount>
 std::shared_ptr<KinematicsFromURDF>
     RobotState<JointCount, BodyCount>::kinematics_;
-
-template <int JointCount, int BodyCount>
-std::shared_ptr<std::mutex>
-    RobotState<JointCount, BodyCount>::kinematics_mutex_;
 }
@@ -0,0 +1,276 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file tile_depth_renderer.cpp
+ * \date October 2026
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <dbrt/tile_depth_renderer.h>
+#include <ros/ros.h>
+
+namespace dbrt
+{
+namespace
+{
+// vertices closer to the camera are not rendered
+const float near_plane = 1e-3f;
+
+typedef Eigen::Array<float, TileDepthRenderer::tile_size, 1> TileRow;
+}
+
+TileDepthRenderer::TileDepthRenderer(
+    const std::vector<PartMeshBuffers>& meshes,
+    const Eigen::Matrix3d& camera_matrix,
+    int n_rows,
+    int n_cols,
+    std::size_t thread_count)
+    : n_rows_(n_rows),
+      n_cols_(n_cols),
+      tiles_x_((n_cols + tile_size - 1) / tile_size),
+      tiles_y_((n_rows + tile_size - 1) / tile_size),
+      fx_(camera_matrix(0, 0)),
+      fy_(camera_matrix(1, 1)),
+      cx_(camera_matrix(0, 2)),
+      cy_(camera_matrix(1, 2)),
+      culler_(camera_matrix, n_rows, n_cols, near_plane),
+      culled_link_count_(0),
+      pool_(thread_count)
+{
+    vertex_offsets_.push_back(0);
+    for (const auto& mesh : meshes)
+    {
+        const std::uint32_t first = vertex_offsets_.back();
+        vertices_.insert(
+            vertices_.end(), mesh.vertices.begin(), mesh.vertices.end());
+        for (auto index : mesh.indices) indices_.push_back(first + index);
+
+        vertex_offsets_.push_back(vertices_.size() / 3);
+
+        sphere_centers_.push_back(mesh.sphere_center);
+        sphere_radii_.push_back(mesh.sphere_radius);
+    }
+    mesh_visible_.resize(meshes.size());
+
+    const std::size_t vertex_count = vertex_offsets_.back();
+    screen_x_.resize(vertex_count);
+    screen_y_.resize(vertex_count);
+    inverse_depth_.resize(vertex_count);
+
+    bins_.resize(pool_.size());
+    for (auto& chunk_bins : bins_) chunk_bins.resize(tiles_x_ * tiles_y_);
+}
+
+void TileDepthRenderer::render(const std::vector<LinkPose>& poses,
+                               std::vector<float>& depth,
+                               float bad_value)
+{
+    depth.resize(n_rows_ * n_cols_);
+
+    const std::size_t mesh_count =
+        std::min(poses.size(), vertex_offsets_.size() - 1);
+
+    culled_link_count_ = 0;
+    for (std::size_t i = 0; i < mesh_count; ++i)
+    {
+        mesh_visible_[i] =
+            culler_.visible(poses[i], sphere_centers_[i], sphere_radii_[i]);
+        if (!mesh_visible_[i]) culled_link_count_++;
+    }
+    ROS_DEBUG("Culled %d of %d links",
+              int(culled_link_count_),
+              int(mesh_visible_.size()));
+
+    pool_.for_each(mesh_count,
+                   [&](std::size_t mesh) { project(mesh, poses); });
+
+    // the vertices of meshes without a pose are not rendered
+    std::fill(inverse_depth_.begin() + vertex_offsets_[mesh_count],
+              inverse_depth_.end(),
+              0.f);
+
+    pool_.for_each(bins_.size(), [this](std::size_t chunk) { bin(chunk); });
+
+    float* depth_data = depth.data();
+    pool_.for_each(tiles_x_ * tiles_y_, [&](std::size_t tile) {
+        rasterize(tile, bad_value, depth_data);
+    });
+}
+
+void TileDepthRenderer::project(std::size_t mesh,
+                                const std::vector<LinkPose>& poses)
+{
+    // the triangles of culled meshes are skipped by bin()
+    if (!mesh_visible_[mesh])
+    {
+        std::fill(inverse_depth_.begin() + vertex_offsets_[mesh],
+                  inverse_depth_.begin() + vertex_offsets_[mesh + 1],
+                  0.f);
+        return;
+    }
+
+    const float* m = poses[mesh].affine;
+
+    for (std::size_t v = vertex_offsets_[mesh]; v < vertex_offsets_[mesh + 1];
+         ++v)
+    {
+        const float* p = &vertices_[3 * v];
+        const float x = m[0] * p[0] + m[1] * p[1] + m[2] * p[2] + m[3];
+        const float y = m[4] * p[0] + m[5] * p[1] + m[6] * p[2] + m[7];
+        const float z = m[8] * p[0] + m[9] * p[1] + m[10] * p[2] + m[11];
+
+        if (z < near_plane)
+        {
+            inverse_depth_[v] = 0.f;
+            continue;
+        }
+
+        const float inverse_z = 1.f / z;
+        screen_x_[v] = fx_ * x * inverse_z + cx_;
+        screen_y_[v] = fy_ * y * inverse_z + cy_;
+        inverse_depth_[v] = inverse_z;
+    }
+}
+
+void TileDepthRenderer::bin(std::size_t chunk)
+{
+    auto& chunk_bins = bins_[chunk];
+    for (auto& tile_bin : chunk_bins) tile_bin.clear();
+
+    const std::size_t triangle_count = indices_.size() / 3;
+    const std::size_t begin = triangle_count * chunk / bins_.size();
+    const std::size_t end = triangle_count * (chunk + 1) / bins_.size();
+
+    for (std::size_t t = begin; t < end; ++t)
+    {
+        const std::uint32_t* v = &indices_[3 * t];
+
+        // triangles crossing the near plane are skipped, not clipped
+        if (inverse_depth_[v[0]] == 0.f || inverse_depth_[v[1]] == 0.f ||
+            inverse_depth_[v[2]] == 0.f)
+        {
+            continue;
+        }
+
+        const float min_x = std::min(
+            {screen_x_[v[0]], screen_x_[v[1]], screen_x_[v[2]]});
+        const float max_x = std::max(
+            {screen_x_[v[0]], screen_x_[v[1]], screen_x_[v[2]]});
+        const float min_y = std::min(
+            {screen_y_[v[0]], screen_y_[v[1]], screen_y_[v[2]]});
+        const float max_y = std::max(
+            {screen_y_[v[0]], screen_y_[v[1]], screen_y_[v[2]]});
+
+        // pixel centers have integer coordinates
+        const int col_begin = std::max(0, int(std::ceil(min_x)));
+        const int col_end = std::min(n_cols_ - 1, int(std::floor(max_x)));
+        const int row_begin = std::max(0, int(std::ceil(min_y)));
+        const int row_end = std::min(n_rows_ - 1, int(std::floor(max_y)));
+        if (col_begin > col_end || row_begin > row_end) continue;
+
+        for (int ty = row_begin / tile_size; ty <= row_end / tile_size; ++ty)
+        {
+            for (int tx = col_begin / tile_size; tx <= col_end / tile_size;
+                 ++tx)
+            {
+                chunk_bins[ty * tiles_x_ + tx].push_back(t);
+            }
+        }
+    }
+}
+
+void TileDepthRenderer::rasterize(std::size_t tile,
+                                  float bad_value,
+                                  float* depth)
+{
+    const int x0 = (tile % tiles_x_) * tile_size;
+    const int y0 = (tile / tiles_x_) * tile_size;
+    const int width = std::min<int>(tile_size, n_cols_ - x0);
+    const int height = std::min<int>(tile_size, n_rows_ - y0);
+
+    // inverse depth of the nearest surface, 0 if none
+    TileRow tile_depth[tile_size];
+    for (int row = 0; row < height; ++row) tile_depth[row].setZero();
+
+    const TileRow xs = TileRow::LinSpaced(x0, x0 + tile_size - 1);
+
+    for (const auto& chunk_bins : bins_)
+    {
+        for (std::uint32_t t : chunk_bins[tile])
+        {
+            std::uint32_t v0 = indices_[3 * t];
+            std::uint32_t v1 = indices_[3 * t + 1];
+            std::uint32_t v2 = indices_[3 * t + 2];
+
+            float area = (screen_x_[v1] - screen_x_[v0]) *
+                             (screen_y_[v2] - screen_y_[v0]) -
+                         (screen_x_[v2] - screen_x_[v0]) *
+                             (screen_y_[v1] - screen_y_[v0]);
+            if (area == 0.f) continue;
+
+            // the rasterizer is independent of the winding
+            if (area < 0.f)
+            {
+                std::swap(v1, v2);
+                area = -area;
+            }
+
+            const float ax = screen_x_[v0], ay = screen_y_[v0];
+            const float bx = screen_x_[v1], by = screen_y_[v1];
+            const float cx = screen_x_[v2], cy = screen_y_[v2];
+
+            // edge functions w_i, which are the barycentric weights of
+            // vertex i times the area
+            const TileRow dx0 = xs - bx;
+            const TileRow dx1 = xs - cx;
+            const TileRow dx2 = xs - ax;
+
+            const float scale = 1.f / area;
+            const float iz0 = inverse_depth_[v0] * scale;
+            const float iz1 = inverse_depth_[v1] * scale;
+            const float iz2 = inverse_depth_[v2] * scale;
+
+            const int row_begin = std::max(
+                y0, int(std::ceil(std::min({ay, by, cy}))));
+            const int row_end = std::min(
+                y0 + height - 1, int(std::floor(std::max({ay, by, cy}))));
+
+            for (int y = row_begin; y <= row_end; ++y)
+            {
+                const TileRow w0 = (cx - bx) * (y - by) - (cy - by) * dx0;
+                const TileRow w1 = (ax - cx) * (y - cy) - (ay - cy) * dx1;
+                const TileRow w2 = (bx - ax) * (y - ay) - (by - ay) * dx2;
+
+                const TileRow inverse_z = w0 * iz0 + w1 * iz1 + w2 * iz2;
+
+                TileRow& row = tile_depth[y - y0];
+                row = ((w0 >= 0.f) && (w1 >= 0.f) && (w2 >= 0.f) &&
+                       (inverse_z > row))
+                          .select(inverse_z, row);
+            }
+        }
+    }
+
+    for (int row = 0; row < height; ++row)
+    {
+        float* out = depth + (y0 + row) * n_cols_ + x0;
+        for (int col = 0; col < width; ++col)
+        {
+            const float inverse_z = tile_depth[row](col);
+            out[col] = inverse_z > 0.f ? 1.f / inverse_z : bad_value;
+        }
+    }
+}
+}
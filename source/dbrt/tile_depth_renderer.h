@@ -0,0 +1,141 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file tile_depth_renderer.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <cstdint>
+#include <dbrt/kinematics_from_urdf.h>
+#include <dbrt/part_mesh_model.h>
+#include <dbrt/util/frustum_culler.h>
+#include <dbrt/util/thread_pool.h>
+#include <vector>
+
+namespace dbrt
+{
+/**
+ * \brief Multi-threaded software depth rasterizer of the robot link meshes.
+ *
+ * A frame is rendered in three parallel passes: all vertices are projected
+ * into the image, the triangles are binned into square screen tiles and the
+ * tiles are rasterized independently. Within a tile, the edge functions and
+ * the inverse depth are evaluated for a whole row of tile pixels at once on
+ * fixed size Eigen arrays, which are vectorized. The depth is the z
+ * coordinate in the camera frame, like the depth of dbot::RigidBodyRenderer.
+ * Links whose bounding sphere lies outside of the view frustum are culled
+ * before projection.
+ *
+ * Render() can be used in place of dbot::RigidBodyRenderer::Render() for
+ * robot states. A renderer instance renders one frame at a time.
+ */
+class TileDepthRenderer
+{
+public:
+    typedef KinematicsFromURDF::LinkPose LinkPose;
+
+    enum
+    {
+        // tile edge length in pixels
+        tile_size = 32
+    };
+
+    /**
+     * \param meshes
+     *     Link meshes in the link frames, indexed like the link poses, with
+     *     up to date bounding spheres
+     * \param camera_matrix
+     *     Intrinsics at the rendered resolution
+     * \param thread_count
+     *     Number of rasterizer threads
+     */
+    TileDepthRenderer(const std::vector<PartMeshBuffers>& meshes,
+                      const Eigen::Matrix3d& camera_matrix,
+                      int n_rows,
+                      int n_cols,
+                      std::size_t thread_count = ThreadPool::default_size());
+
+    /**
+     * \brief Renders the links at the given camera relative poses into the
+     *        row-major depth buffer of n_rows x n_cols entries. Pixels not
+     *        covered by any link are set to bad_value.
+     */
+    void render(const std::vector<LinkPose>& poses,
+                std::vector<float>& depth,
+                float bad_value);
+
+    /**
+     * \brief Renders the link poses of a robot state, i.e. a state providing
+     *        the renderer-ready link_poses() of RobotState
+     */
+    template <typename State>
+    void Render(const State& state,
+                Eigen::VectorXd& depth_image,
+                double bad_value)
+    {
+        render(state.link_poses(), depth_, bad_value);
+        depth_image = Eigen::Map<const Eigen::VectorXf>(
+                          depth_.data(), depth_.size())
+                          .cast<double>();
+    }
+
+    int n_rows() const { return n_rows_; }
+    int n_cols() const { return n_cols_; }
+
+    // number of links culled in the last frame
+    std::size_t culled_link_count() const { return culled_link_count_; }
+
+private:
+    void project(std::size_t mesh, const std::vector<LinkPose>& poses);
+    void bin(std::size_t chunk);
+    void rasterize(std::size_t tile, float bad_value, float* depth);
+
+private:
+    int n_rows_;
+    int n_cols_;
+    int tiles_x_;
+    int tiles_y_;
+    float fx_, fy_, cx_, cy_;
+
+    // vertices of all meshes in the link frames, interleaved x, y, z, and
+    // the triangles with vertex indices into the joint vertex buffer
+    std::vector<float> vertices_;
+    std::vector<std::uint32_t> indices_;
+    // first vertex of each mesh and one past the last
+    std::vector<std::size_t> vertex_offsets_;
+    // bounding spheres of the meshes in the link frames
+    std::vector<Eigen::Vector3f> sphere_centers_;
+    std::vector<float> sphere_radii_;
+
+    FrustumCuller culler_;
+    std::vector<char> mesh_visible_;
+    std::size_t culled_link_count_;
+
+    // projected vertices: image coordinates and inverse depth, which is 0
+    // for vertices behind the near plane
+    std::vector<float> screen_x_;
+    std::vector<float> screen_y_;
+    std::vector<float> inverse_depth_;
+
+    // triangles overlapping each tile, binned per triangle chunk
+    std::vector<std::vector<std::vector<std::uint32_t>>> bins_;
+
+    std::vector<float> depth_;
+
+    ThreadPool pool_;
+};
+}
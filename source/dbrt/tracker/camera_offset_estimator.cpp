@@ -0,0 +1,115 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file camera_offset_estimator.cpp
+ * \date October 2026
+ */
+
+#include <dbrt/tracker/camera_offset_estimator.h>
+#include <ros/ros.h>
+
+namespace dbrt
+{
+CameraOffsetEstimator::CameraOffsetEstimator(
+    const VisualTrackerFactory& visual_tracker_factory,
+    const std::shared_ptr<KinematicsFromURDF>& kinematics,
+    double rate)
+    : visual_tracker_factory_(visual_tracker_factory),
+      kinematics_(kinematics),
+      period_(std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+          std::chrono::duration<double>(1.0 / rate))),
+      next_estimation_(std::chrono::steady_clock::now()),
+      pending_(false),
+      running_(false),
+      estimation_count_(0)
+{
+}
+
+CameraOffsetEstimator::~CameraOffsetEstimator()
+{
+    shutdown();
+}
+
+void CameraOffsetEstimator::run()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (running_) return;
+
+    running_ = true;
+    thread_ = std::thread(&CameraOffsetEstimator::run_estimator, this);
+}
+
+void CameraOffsetEstimator::shutdown()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    condition_.notify_all();
+
+    if (thread_.joinable()) thread_.join();
+}
+
+void CameraOffsetEstimator::update(const Obsrv& image, const State& state)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const auto now = std::chrono::steady_clock::now();
+    if (!running_ || pending_ || now < next_estimation_) return;
+
+    image_ = image;
+    state_ = state;
+    pending_ = true;
+    next_estimation_ = now + period_;
+
+    condition_.notify_one();
+}
+
+std::size_t CameraOffsetEstimator::estimation_count() const
+{
+    return estimation_count_;
+}
+
+void CameraOffsetEstimator::run_estimator()
+{
+    // the tracker is created here such that its renderer belongs to this
+    // thread
+    std::shared_ptr<VisualTracker> offset_tracker = visual_tracker_factory_();
+
+    ROS_INFO("Camera offset estimator running ...");
+
+    Obsrv image;
+    State state;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]() { return !running_ || pending_; });
+            if (!running_) break;
+
+            image.swap(image_);
+            state = state_;
+            pending_ = false;
+        }
+
+        // start from the joint estimate and the current offset. Only the
+        // camera offset is sampled.
+        offset_tracker->initialize({state});
+        offset_tracker->track(image);
+
+        kinematics_->set_camera_offset(offset_tracker->camera_offset());
+        estimation_count_++;
+    }
+}
+}
@@ -0,0 +1,104 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file camera_offset_estimator.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <dbrt/kinematics_from_urdf.h>
+#include <dbrt/tracker/visual_tracker.h>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace dbrt
+{
+/**
+ * \brief Refines the camera offset at a low rate on its own thread.
+ *
+ * The camera offset drifts much slower than the joints move. Instead of
+ * sampling it in every frame, the per frame visual tracker only samples the
+ * joints and this estimator runs a visual tracker which only samples the
+ * camera offset while the joints stay at their estimate. Each refined offset
+ * is published through KinematicsFromURDF::set_camera_offset().
+ */
+class CameraOffsetEstimator
+{
+public:
+    typedef VisualTracker::State State;
+    typedef VisualTracker::Obsrv Obsrv;
+
+    typedef std::function<std::shared_ptr<VisualTracker>()>
+        VisualTrackerFactory;
+
+public:
+    /**
+     * \param visual_tracker_factory
+     *     Creates the camera offset only visual tracker. It is invoked on the
+     *     estimator thread.
+     * \param kinematics
+     *     Kinematics the refined offset is published to
+     * \param rate
+     *     Number of estimations per second
+     */
+    CameraOffsetEstimator(
+        const VisualTrackerFactory& visual_tracker_factory,
+        const std::shared_ptr<KinematicsFromURDF>& kinematics,
+        double rate);
+
+    ~CameraOffsetEstimator();
+
+    void run();
+    void shutdown();
+
+    /**
+     * \brief Offers an image together with the joint state estimated for it.
+     *        Both are only copied if the next estimation is due, otherwise
+     *        the call returns immediately.
+     */
+    void update(const Obsrv& image, const State& state);
+
+    /**
+     * \brief Number of offsets published so far
+     */
+    std::size_t estimation_count() const;
+
+private:
+    void run_estimator();
+
+private:
+    VisualTrackerFactory visual_tracker_factory_;
+    std::shared_ptr<KinematicsFromURDF> kinematics_;
+    std::chrono::steady_clock::duration period_;
+    std::chrono::steady_clock::time_point next_estimation_;
+
+    // latest image and state handed over by update()
+    Obsrv image_;
+    State state_;
+    bool pending_;
+
+    bool running_;
+    std::atomic<std::size_t> estimation_count_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::thread thread_;
+};
+}
@@ -17,13 +17,22 @@
  * \author Jan Issac (jan.issac@gmail.com)
  */
 
+#include <cerrno>
+#include <cstdint>
 #include <dbot_ros/util/ros_interface.h>
 #include <dbrt/tracker/fusion_tracker.h>
 #include <ros/ros.h>
 #include <sensor_msgs/JointState.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 namespace dbrt
 {
+// At 1kHz this holds about 16 seconds of unprocessed joint observations
+static const std::size_t joints_obsrv_buffer_capacity = 1 << 14;
+static const std::size_t joints_obsrv_belief_buffer_capacity = 10000;
+
 FusionTracker::FusionTracker(
     const std::shared_ptr<dbot::CameraData>& camera_data,
     const std::shared_ptr<KinematicsFromURDF>& kinematics,
@@ -35,13 +44,34 @@ FusionTracker::FusionTracker(
       visual_tracker_factory_(visual_tracker_factory),
       running_(true),
       camera_delay_(camera_delay),
-      ros_image_updated_(false)
+      ros_image_updated_(false),
+      joints_obsrvs_buffer_(kinematics->num_joints(),
+                            joints_obsrv_buffer_capacity),
+      joints_obsrv_callback_buffer_(kinematics->num_joints()),
+      joints_obsrv_replay_pending_(false),
+      joints_obsrv_belief_buffer_(
+          kinematics->num_joints(),
+          kinematics->num_joints() * RotaryTracker::JointSnapshotDim,
+          joints_obsrv_belief_buffer_capacity),
+      joints_obsrv_belief_generation_(0),
+      joints_obsrv_event_(eventfd(0, EFD_CLOEXEC)),
+      joints_obsrv_waiting_(false)
 {
+    if (joints_obsrv_event_ < 0)
+    {
+        throw std::runtime_error("Cannot create the rotary tracker eventfd");
+    }
+
     gaussian_joint_tracker_ = rotary_tracker_factory();
     i_t = 0;
     j_t = 0;
 }
 
+FusionTracker::~FusionTracker()
+{
+    close(joints_obsrv_event_);
+}
+
 void FusionTracker::initialize(const std::vector<State>& initial_states)
 {
     current_state_ = initial_states[0];
@@ -54,60 +84,119 @@ void FusionTracker::run_rotary_tracker()
 
     while (running_)
     {
-        usleep(10);
-        std::deque<JointsObsrvEntry> joints_obsrvs_buffer_local;
-        {
-            std::lock_guard<std::mutex> lock(joints_obsrv_buffer_mutex_);
-            if (joints_obsrvs_buffer_.size() == 0) continue;
-            joints_obsrvs_buffer_.swap(joints_obsrvs_buffer_local);
-        }
+        // sleep until joint observations arrive or we are shut down
+        wait_for_joints_obsrvs();
+        if (!running_) break;
 
-        State current_state;
-        double current_time;
-        JointsObsrv current_angle_measurement;
-        {
-            std::lock_guard<std::mutex> state_lock(current_state_mutex_);
-            current_state = current_state_;
-            current_time = current_time_;
-            current_angle_measurement = current_angle_measurement_;
-        }
+        process_joints_obsrvs();
+    }
+}
+
+void FusionTracker::process_joints_obsrvs()
+{
+    auto& joints_obsrv_entry = rotary_joints_obsrv_entry_;
+    auto& current_state = rotary_current_state_;
+    auto& current_time = rotary_current_time_;
+    auto& current_angle_measurement = rotary_current_angle_measurement_;
 
+    {
+        std::lock_guard<std::mutex> state_lock(current_state_mutex_);
+        current_state = current_state_;
+        current_time = current_time_;
+        current_angle_measurement = current_angle_measurement_;
+    }
+
+    {
+        // The visual tracker resets the rotary beliefs and invalidates the
+        // history snapshots while holding the belief buffer lock. Holding it
+        // here guarantees that the replayed observations are processed
+        // before any newer one from the incoming buffer.
         std::lock_guard<std::mutex> belief_buffer_lock(
             joints_obsrv_belief_buffer_mutex_);
-        for (auto joints_obsrv_entry : joints_obsrvs_buffer_local)
+        joints_obsrv_replay_pending_ = false;
+
+        // replay after a visual correction
+        track_joints_obsrvs(
+            current_state, current_time, current_angle_measurement);
+
+        while (joints_obsrvs_buffer_.pop(joints_obsrv_entry.timestamp,
+                                         joints_obsrv_entry.obsrv))
         {
-            // construct a joints belief entry which contains the following
-            //  - the joints measurement values
-            //  - their time stamp
-            //  - the updated joints belief
-            JointsBeliefEntry joints_belief_entry;
-            joints_belief_entry.joints_obsrv_entry = joints_obsrv_entry;
-
-            current_state = gaussian_joint_tracker_->track(
-                joints_belief_entry.joints_obsrv_entry.obsrv);
-            current_time = joints_belief_entry.joints_obsrv_entry.timestamp;
-            current_angle_measurement =
-                joints_belief_entry.joints_obsrv_entry.obsrv;
-
-            joints_belief_entry.beliefs = gaussian_joint_tracker_->beliefs();
-
-            // update sliding window of belief and joints obsrv entries
-            joints_obsrv_belief_buffer_.push_back(joints_belief_entry);
-            if (joints_obsrv_belief_buffer_.size() > 10000)
+            if (!joints_obsrv_belief_buffer_.push_back(
+                    joints_obsrv_entry.timestamp, joints_obsrv_entry.obsrv))
             {
                 ROS_WARN(
                     "Belief buffer max size reached ... discarding oldest "
                     "belief. It seems the visual tracker is too slow.");
-                joints_obsrv_belief_buffer_.pop_front();
             }
+            track_joints_obsrvs(
+                current_state, current_time, current_angle_measurement);
         }
+        joints_obsrv_belief_generation_++;
+    }
+    joints_obsrv_belief_condition_.notify_all();
 
-        {
-            std::lock_guard<std::mutex> state_lock(current_state_mutex_);
-            current_state_ = current_state;
-            current_time_ = current_time;
-            current_angle_measurement_ = current_angle_measurement;
-        }
+    {
+        std::lock_guard<std::mutex> state_lock(current_state_mutex_);
+        current_state_ = current_state;
+        current_time_ = current_time;
+        current_angle_measurement_ = current_angle_measurement;
+    }
+}
+
+void FusionTracker::wait_for_joints_obsrvs()
+{
+    // Announce the sleep before checking for work. A producer either sees
+    // the flag and writes the eventfd, or its work is seen here.
+    joints_obsrv_waiting_ = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!running_ || !joints_obsrvs_buffer_.empty() ||
+        joints_obsrv_replay_pending_)
+    {
+        joints_obsrv_waiting_ = false;
+        return;
+    }
+
+    // a wake up which raced with the check above only causes one spurious
+    // return later on
+    std::uint64_t count;
+    while (read(joints_obsrv_event_, &count, sizeof(count)) < 0 &&
+           errno == EINTR)
+    {
+    }
+}
+
+void FusionTracker::wake_rotary_tracker()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (!joints_obsrv_waiting_.exchange(false)) return;
+
+    const std::uint64_t count = 1;
+    if (write(joints_obsrv_event_, &count, sizeof(count)) < 0)
+    {
+        ROS_ERROR_THROTTLE(1.0, "Cannot wake the rotary tracker");
+    }
+}
+
+void FusionTracker::track_joints_obsrvs(State& current_state,
+                                        double& current_time,
+                                        JointsObsrv& current_angle_measurement)
+{
+    auto& history = joints_obsrv_belief_buffer_;
+
+    // track every history entry which has no belief snapshot yet and store
+    // the updated joints belief in place
+    while (history.snapshot_count() < history.size())
+    {
+        const std::size_t index = history.snapshot_count();
+
+        current_time = history.timestamp(index);
+        current_angle_measurement = history.obsrv(index);
+        gaussian_joint_tracker_->track(current_angle_measurement,
+                                       current_state);
+
+        gaussian_joint_tracker_->beliefs_snapshot(history.snapshot(index));
+        history.commit_snapshot();
     }
 }
 
@@ -126,18 +215,17 @@ void FusionTracker::run_visual_tracker()
     while (running_)
     {
         // continue only if there is a new image available
-        usleep(100);
         {
-            std::lock_guard<std::mutex> lock(image_obsrvs_mutex_);
-            if (!ros_image_updated_)
-            {
-                continue;
-            }
+            std::unique_lock<std::mutex> lock(image_obsrvs_mutex_);
+            image_obsrv_condition_.wait(lock, [this]() {
+                return !running_ || ros_image_updated_;
+            });
+            if (!running_) break;
         }
 
         /**
-         * #1 SWAP ROTARY BELIEF QUEUES SECURLY
-         * #2 GET ROTARY BELIEF AND ITS INDEX FOR IMAGE TIMESTAMP
+         * #1 LOCK ROTARY BELIEF HISTORY
+         * #2 LOOK UP ROTARY BELIEF FOR IMAGE TIMESTAMP
          * #3 CONSTRUCT STATE AND NOISE MATRIX FROM ROTARY BELIEF
          * #4 GET PROCESS MODEL
          * #5 SET PROCESS MODEL NOISE COVARIANCE
@@ -150,40 +238,42 @@ void FusionTracker::run_visual_tracker()
 
         INIT_PROFILING;
 
-        JointsBeliefEntry belief_entry;
-        int belief_index;
-
-        // #1
-        std::deque<JointsBeliefEntry> joints_obsrv_belief_buffer_local;
+        double image_timestamp;
         {
-            std::lock_guard<std::mutex> belief_buffer_lock(
-                joints_obsrv_belief_buffer_mutex_);
-
-            joints_obsrv_belief_buffer_.swap(joints_obsrv_belief_buffer_local);
+            std::lock_guard<std::mutex> lock(image_obsrvs_mutex_);
+            image_timestamp = ros_image_.header.stamp.toSec();
         }
 
-        // #2
-        belief_index = find_belief_entry(joints_obsrv_belief_buffer_local,
-                                         ros_image_.header.stamp.toSec(),
-                                         belief_entry);
-        if (belief_index < 0)
+        // #1, #2, #3
+        double belief_timestamp;
+        State mean;
+        Eigen::MatrixXd cov_sqrt;
         {
-            // no belief found, put back extracted beliefs from local to global
-            // buffer
-            std::lock_guard<std::mutex> belief_buffer_lock(
+            std::unique_lock<std::mutex> belief_buffer_lock(
                 joints_obsrv_belief_buffer_mutex_);
-            while (joints_obsrv_belief_buffer_local.size() > 0)
+
+            int belief_index =
+                joints_obsrv_belief_buffer_.find(image_timestamp);
+            if (belief_index < 0)
             {
-                joints_obsrv_belief_buffer_.push_front(
-                    joints_obsrv_belief_buffer_local.back());
-                joints_obsrv_belief_buffer_local.pop_back();
+                // the image can only be matched once the rotary tracker has
+                // processed newer joint observations
+                std::size_t belief_generation = joints_obsrv_belief_generation_;
+                joints_obsrv_belief_condition_.wait(
+                    belief_buffer_lock, [this, belief_generation]() {
+                        return !running_ || joints_obsrv_belief_generation_ !=
+                                                belief_generation;
+                    });
+                continue;
             }
-            continue;
-        }
 
-        // #3
-        auto mean = get_state_from_belief(belief_entry);
-        auto cov_sqrt = get_covariance_sqrt_from_belief(belief_entry);
+            auto beliefs_snapshot =
+                joints_obsrv_belief_buffer_.snapshot(belief_index);
+            belief_timestamp =
+                joints_obsrv_belief_buffer_.timestamp(belief_index);
+            mean = get_state_from_belief(beliefs_snapshot);
+            cov_sqrt = get_covariance_sqrt_from_belief(beliefs_snapshot);
+        }
 
         // #4
         auto transition = std::static_pointer_cast<
@@ -212,120 +302,79 @@ void FusionTracker::run_visual_tracker()
         current_state = particle_tracker->track(image);
         auto cov = particle_tracker->filter()->belief().covariance();
 
+        if (camera_offset_estimator_)
+        {
+            camera_offset_estimator_->update(image, current_state);
+        }
+
         // #8
         auto angle_beliefs = get_angel_beliefs_from_moments(current_state, cov);
 
         // #9
         std::lock_guard<std::mutex> belief_buffer_lock(
             joints_obsrv_belief_buffer_mutex_);
-        std::lock_guard<std::mutex> lock(joints_obsrv_buffer_mutex_);
 
-        gaussian_joint_tracker_->set_beliefs(belief_entry.beliefs);
-        gaussian_joint_tracker_->set_angle_beliefs(angle_beliefs);
-
-        while (joints_obsrv_belief_buffer_.size() > 0)
+        // throw away beliefs prior to the matched belief
+        joints_obsrv_belief_buffer_.evict_older_than(belief_timestamp);
+        if (joints_obsrv_belief_buffer_.snapshot_count() == 0 ||
+            joints_obsrv_belief_buffer_.timestamp(0) != belief_timestamp)
         {
-            joints_obsrvs_buffer_.push_front(
-                joints_obsrv_belief_buffer_.back().joints_obsrv_entry);
-            joints_obsrv_belief_buffer_.pop_back();
+            ROS_WARN(
+                "The joint belief matching the image has been discarded "
+                "while the visual tracker was running. Skipping the visual "
+                "correction.");
+            continue;
         }
 
-        // throw away obsrv prior to belief index
-        for (int i = 0; i < belief_index; ++i)
-        {
-            joints_obsrv_belief_buffer_local.pop_front();
-        }
+        gaussian_joint_tracker_->set_beliefs(
+            joints_obsrv_belief_buffer_.snapshot(0));
+        gaussian_joint_tracker_->set_angle_beliefs(angle_beliefs);
 
-        // add back joint observations after belief index
-        while (joints_obsrv_belief_buffer_local.size() > 0)
-        {
-            joints_obsrvs_buffer_.push_front(
-                joints_obsrv_belief_buffer_local.back().joints_obsrv_entry);
-            joints_obsrv_belief_buffer_local.pop_back();
-        }
+        // #10 replay the joint observations starting at the matched belief.
+        // The observations stay in the history and their snapshots are
+        // overwritten during the replay.
+        joints_obsrv_belief_buffer_.invalidate_snapshots();
+        joints_obsrv_replay_pending_ = true;
 
-        // MEASURE("total time for visual processing");
-    }
-}
+        // let the rotary tracker replay the joint observations
+        wake_rotary_tracker();
 
-int FusionTracker::find_belief_entry(const std::deque<JointsBeliefEntry>& queue,
-                                     double timestamp,
-                                     JointsBeliefEntry& belief_entry)
-{
-    int index = 0;
-    double min = std::numeric_limits<double>::max();
-    double max = std::numeric_limits<double>::min();
-    for (const auto entry : queue)
-    {
-        min = std::min(min, entry.joints_obsrv_entry.timestamp);
-        max = std::max(max, entry.joints_obsrv_entry.timestamp);
-
-        if (entry.joints_obsrv_entry.timestamp > timestamp)
-        {
-            belief_entry = entry;
-            return index;
-        }
-        index++;
+        // MEASURE("total time for visual processing");
     }
-
-    // debugging information
-    // if (i_t > j_t)
-    // {
-    //     std::cout << ">>>>>>>>> ";
-    // }
-    // else
-    // {
-    //     std::cout << "<<<<<<<<< ";
-    // }
-    // std::cout << "Waiting for processed joint observation beliefs. "
-    //           << "Unprocessed observations: " << joints_obsrvs_buffer_.size()
-    //           << " ("
-    //           << " image t: " << i_t << ", joints t: " << j_t
-    //           << "; diff: " << i_t - j_t << ")" << std::endl;
-    // std::cout.precision(20);
-    // std::cout << "could not find a matching belief for time stamp "
-    //           << timestamp << " (delta: " << timestamp - max << ")" <<
-    //           std::endl;
-    // std::cout << "latest processed obsrv: " << max << std::endl;
-    // std::cout << "oldest processed obsrv: " << min << std::endl;
-    // std::cout << "unprocessed obsrvs size: " << joints_obsrvs_buffer_.size()
-    //           << ", processed buffer size: " << queue.size() << std::endl;
-    // if (joints_obsrvs_buffer_.size())
-    // {
-    //     std::cout << "joints_obsrvs_buffer_.back().timestamp" <<
-    //         joints_obsrvs_buffer_.back().timestamp << std::endl;
-    // }
-
-    return -1;
 }
 
-auto FusionTracker::get_state_from_belief(const JointsBeliefEntry& entry)
-    -> State
+auto FusionTracker::get_state_from_belief(
+    const Eigen::Ref<const Eigen::VectorXd>& beliefs_snapshot) -> State
 {
     State state;
-    state.resize(entry.beliefs.size());
+    state.resize(beliefs_snapshot.size() / RotaryTracker::JointSnapshotDim);
     for (int i = 0; i < state.size(); ++i)
     {
-        state(i, 0) = entry.beliefs[i].mean()(0, 0);
+        state(i, 0) = beliefs_snapshot(i * RotaryTracker::JointSnapshotDim);
     }
 
     return state;
 }
 
 Eigen::MatrixXd FusionTracker::get_covariance_sqrt_from_belief(
-    const FusionTracker::JointsBeliefEntry& entry)
+    const Eigen::Ref<const Eigen::VectorXd>& beliefs_snapshot)
 {
+    const int joint_count =
+        beliefs_snapshot.size() / RotaryTracker::JointSnapshotDim;
+
     Eigen::MatrixXd cov_sqrt;
-    cov_sqrt.setZero(entry.beliefs.size(), entry.beliefs.size());
+    cov_sqrt.setZero(joint_count, joint_count);
 
-    if (entry.beliefs.size() == 0)
+    if (joint_count == 0)
     {
         throw std::runtime_error("Something is wrong. The beliefs are empty.");
     }
 
     for (int i = 0; i < cov_sqrt.rows(); ++i)
     {
-        cov_sqrt(i, i) = std::sqrt(entry.beliefs[i].covariance()(0, 0));
+        // the snapshot stores the angle variance right after the mean
+        const int offset = i * RotaryTracker::JointSnapshotDim;
+        cov_sqrt(i, i) = std::sqrt(beliefs_snapshot(offset + 2));
     }
 
     return cov_sqrt;
@@ -359,13 +408,36 @@ void FusionTracker::run()
         std::thread(&FusionTracker::run_rotary_tracker, this);
     particle_tracker_thread_ =
         std::thread(&FusionTracker::run_visual_tracker, this);
+
+    if (camera_offset_estimator_) camera_offset_estimator_->run();
 }
 
 void FusionTracker::shutdown()
 {
     running_ = false;
-    gaussian_tracker_thread_.join();
-    particle_tracker_thread_.join();
+
+    // Acquiring the mutexes guarantees that no thread is between checking its
+    // wait condition and going to sleep, so no wake up gets lost.
+    {
+        std::lock_guard<std::mutex> lock(joints_obsrv_belief_buffer_mutex_);
+    }
+    {
+        std::lock_guard<std::mutex> lock(image_obsrvs_mutex_);
+    }
+    wake_rotary_tracker();
+    joints_obsrv_belief_condition_.notify_all();
+    image_obsrv_condition_.notify_all();
+
+    if (gaussian_tracker_thread_.joinable()) gaussian_tracker_thread_.join();
+    if (particle_tracker_thread_.joinable()) particle_tracker_thread_.join();
+
+    if (camera_offset_estimator_) camera_offset_estimator_->shutdown();
+}
+
+void FusionTracker::camera_offset_estimator(
+    const std::shared_ptr<CameraOffsetEstimator>& estimator)
+{
+    camera_offset_estimator_ = estimator;
 }
 
 void FusionTracker::current_state_and_time(State& current_state,
@@ -377,6 +449,11 @@ void FusionTracker::current_state_and_time(State& current_state,
     current_time = current_time_;
 }
 
+const JointsObsrvRingBuffer& FusionTracker::joints_obsrv_buffer() const
+{
+    return joints_obsrvs_buffer_;
+}
+
 void FusionTracker::current_things(State& current_state,
                                    double& current_time,
                                    JointsObsrv& current_angle_measurement) const
@@ -391,26 +468,31 @@ void FusionTracker::current_things(State& current_state,
 void FusionTracker::joints_obsrv_callback(
     const sensor_msgs::JointState& joint_msg)
 {
-    std::lock_guard<std::mutex> lock(joints_obsrv_buffer_mutex_);
-
-    JointsObsrvEntry entry;
-    entry.timestamp = joint_msg.header.stamp.toSec();
-    entry.obsrv = kinematics_->sensor_msg_to_eigen(joint_msg);
-    joints_obsrvs_buffer_.push_back(entry);
+    double timestamp = joint_msg.header.stamp.toSec();
+    if (!kinematics_->sensor_msg_to_eigen(
+            joint_msg, joints_obsrv_callback_buffer_, joints_obsrv_layouts_))
+    {
+        // the missing joints would be taken from the previous message
+        ROS_ERROR_THROTTLE(1.0,
+                           "Skipping a joint state message which does not "
+                           "contain all robot joints");
+        return;
+    }
 
-    if (joints_obsrvs_buffer_.size() > 1000000)
+    if (!joints_obsrvs_buffer_.push(timestamp, joints_obsrv_callback_buffer_))
     {
-        ROS_WARN_STREAM("Joint angle max buffer size ("
-                        << 1000000
-                        << ") "
-                        << "reached! This means most likely that no image "
-                        << "has been received in a while. Old joint angles "
-                        << "can only be discarded once an image with a later "
-                        << "time stamp is received.");
-        joints_obsrvs_buffer_.pop_front();
+        ROS_WARN_STREAM_THROTTLE(
+            1.0,
+            "Joint angle buffer full ("
+                << joints_obsrvs_buffer_.capacity()
+                << ")! Dropping joint angle measurement. This means most "
+                << "likely that the rotary tracker cannot keep up with the "
+                << "joint state rate. Dropped measurements so far: "
+                << joints_obsrvs_buffer_.dropped_count());
     }
 
-    if (j_t > entry.timestamp)
+    // j_t is only written here, the image callback merely reads it
+    if (j_t.load(std::memory_order_relaxed) > timestamp)
     {
         ROS_WARN_STREAM("Joint angle measurements not ordered! This means "
                         << "that a joint angle measurement was received with "
@@ -419,7 +501,9 @@ void FusionTracker::joints_obsrv_callback(
                         << "never occurr and is not handled!");
     }
 
-    j_t = entry.timestamp;
+    j_t.store(timestamp, std::memory_order_relaxed);
+
+    wake_rotary_tracker();
 }
 
 void FusionTracker::image_obsrv_callback(const sensor_msgs::Image& ros_image)
@@ -430,9 +514,9 @@ void FusionTracker::image_obsrv_callback(const sensor_msgs::Image& ros_image)
     ros_image_ = ros_image;
     ros_image_.header.stamp.fromSec(ros_image_.header.stamp.toSec() -
                                     camera_delay_);
+    image_obsrv_condition_.notify_one();
 
-    std::lock_guard<std::mutex> lock_joint_obsrv(joints_obsrv_buffer_mutex_);
-
+    const double j_t = this->j_t.load(std::memory_order_relaxed);
     if (i_t > ros_image_.header.stamp.toSec())
     {
         ROS_WARN_STREAM("Image measurements not ordered! This means that an "
@@ -19,9 +19,14 @@
 
 #pragma once
 
+#include <dbrt/tracker/camera_offset_estimator.h>
 #include <dbrt/tracker/robot_tracker.h>
 #include <dbrt/tracker/rotary_tracker.h>
 #include <dbrt/tracker/visual_tracker.h>
+#include <dbrt/util/belief_history.h>
+#include <dbrt/util/joints_obsrv_ring_buffer.h>
+#include <atomic>
+#include <condition_variable>
 #include <deque>
 #include <fl/filter/gaussian/gaussian_filter_linear.hpp>
 #include <fl/model/sensor/linear_gaussian_sensor.hpp>
@@ -62,12 +67,6 @@ public:
         JointsObsrv obsrv;
     };
 
-    struct JointsBeliefEntry
-    {
-        JointsObsrvEntry joints_obsrv_entry;
-        std::vector<JointBelief> beliefs;
-    };
-
 public:
     FusionTracker(const std::shared_ptr<dbot::CameraData>& camera_data,
                   const std::shared_ptr<KinematicsFromURDF>& kinematics,
@@ -75,6 +74,8 @@ public:
                   const VisualTrackerFactory& visual_tracker_factory,
                   double camera_delay);
 
+    ~FusionTracker();
+
     /**
      * \brief Initializes the filters with the given initial states and
      *    the number of evaluations
@@ -84,6 +85,11 @@ public:
     void run();
     void shutdown();
 
+    /**
+     * \brief Converts and buffers a joint observation and wakes the rotary
+     *        tracker. Takes no lock, so the rotary and visual threads cannot
+     *        block it. Must only be called from one thread.
+     */
     void joints_obsrv_callback(const sensor_msgs::JointState& joints_obsrv);
     void image_obsrv_callback(const sensor_msgs::Image& ros_image);
 
@@ -93,32 +99,68 @@ public:
                         double& current_time,
                         JointsObsrv& current_angle_measurement) const;
 
+    /**
+     * \brief Incoming joint observation buffer. Provides the overflow and
+     *        drop counters.
+     */
+    const JointsObsrvRingBuffer& joints_obsrv_buffer() const;
+
+    /**
+     * \brief Sets the estimator refining the camera offset on its own thread.
+     *        It is fed with the images and state estimates of the visual
+     *        tracker and runs from run() to shutdown().
+     */
+    void camera_offset_estimator(
+        const std::shared_ptr<CameraOffsetEstimator>& estimator);
+
 protected:
     void run_rotary_tracker();
     void run_visual_tracker();
 
+    /**
+     * \brief One step of the rotary tracker thread. Replays the belief
+     *        history after a visual correction, tracks the buffered joint
+     *        observations and publishes the resulting current state.
+     */
+    void process_joints_obsrvs();
+
 private:
-    int find_belief_entry(const std::deque<JointsBeliefEntry>& queue,
-                          double timestamp,
-                          JointsBeliefEntry& belief_entry);
-    State get_state_from_belief(const JointsBeliefEntry& entry);
+    /**
+     * \brief Blocks the rotary tracker thread until a joint observation, a
+     *        replay request or the shutdown arrives
+     */
+    void wait_for_joints_obsrvs();
+
+    /**
+     * \brief Wakes the rotary tracker thread if it is waiting. Lock-free.
+     */
+    void wake_rotary_tracker();
+
+    void track_joints_obsrvs(State& current_state,
+                             double& current_time,
+                             JointsObsrv& current_angle_measurement);
+    State get_state_from_belief(
+        const Eigen::Ref<const Eigen::VectorXd>& beliefs_snapshot);
     Eigen::MatrixXd get_covariance_sqrt_from_belief(
-        const JointsBeliefEntry& entry);
+        const Eigen::Ref<const Eigen::VectorXd>& beliefs_snapshot);
 
     std::vector<RotaryTracker::AngleBelief> get_angel_beliefs_from_moments(
         const State& mean,
         const Eigen::MatrixXd& cov);
 
 private:
+    // latest image time stamp, guarded by image_obsrvs_mutex_
     double i_t;
-    double j_t;
+    // latest joint observation time stamp, written by joints_obsrv_callback()
+    std::atomic<double> j_t;
 
     VisualTrackerFactory visual_tracker_factory_;
     std::shared_ptr<dbot::CameraData> camera_data_;
     std::shared_ptr<KinematicsFromURDF> kinematics_;
     std::shared_ptr<RotaryTracker> gaussian_joint_tracker_;
+    std::shared_ptr<CameraOffsetEstimator> camera_offset_estimator_;
 
-    bool running_;
+    std::atomic<bool> running_;
     double camera_delay_;
 
     State current_state_;
@@ -128,15 +170,48 @@ private:
     // We need this to calculate "measured" tfs at the same point in time.
     JointsObsrv current_angle_measurement_;
 
+    // Working copies of the rotary tracker thread, reused across
+    // process_joints_obsrvs() calls such that the steady state does not
+    // allocate
+    JointsObsrvEntry rotary_joints_obsrv_entry_;
+    State rotary_current_state_;
+    double rotary_current_time_;
+    JointsObsrv rotary_current_angle_measurement_;
+
     sensor_msgs::Image ros_image_;
     bool ros_image_updated_;
-    std::deque<JointsObsrvEntry> joints_obsrvs_buffer_;
-    std::deque<JointsBeliefEntry> joints_obsrv_belief_buffer_;
+    // Incoming joint observations. Filled by joints_obsrv_callback() and
+    // drained by the rotary tracker thread without locking.
+    JointsObsrvRingBuffer joints_obsrvs_buffer_;
+    // Conversion buffer and joint state layouts of joints_obsrv_callback().
+    // Owned by the callback, so the conversion takes no lock.
+    JointsObsrv joints_obsrv_callback_buffer_;
+    KinematicsFromURDF::JointLayoutCache joints_obsrv_layouts_;
+    // Set by the visual tracker after a correction. The rotary tracker then
+    // replays the observations in the belief history before any newer one.
+    std::atomic<bool> joints_obsrv_replay_pending_;
+    // Joint observations and the compact rotary belief snapshots after each
+    // of them. The visual tracker looks up the belief matching the image time
+    // stamp here.
+    BeliefHistory joints_obsrv_belief_buffer_;
 
-    mutable std::mutex joints_obsrv_buffer_mutex_;
     mutable std::mutex joints_obsrv_belief_buffer_mutex_;
     mutable std::mutex image_obsrvs_mutex_;
     mutable std::mutex current_state_mutex_;
+
+    // wake up the worker threads as soon as there is something to do instead
+    // of polling the buffers
+    std::condition_variable joints_obsrv_belief_condition_;
+    std::condition_variable image_obsrv_condition_;
+    std::size_t joints_obsrv_belief_generation_;
+
+    // The rotary tracker sleeps on this eventfd. It announces the sleep in
+    // joints_obsrv_waiting_ before it checks for work a last time, so the
+    // producers only write the eventfd if the thread may be asleep and no
+    // wake up gets lost.
+    int joints_obsrv_event_;
+    std::atomic<bool> joints_obsrv_waiting_;
+
     std::thread gaussian_tracker_thread_;
     std::thread particle_tracker_thread_;
 };
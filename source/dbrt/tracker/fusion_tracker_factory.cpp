@@ -38,6 +38,7 @@
 #include <dbrt/kinematics_from_urdf.h>
 #include <dbrt/robot_publisher.h>
 #include <dbrt/robot_state.h>
+#include <dbrt/tracker/camera_offset_estimator.h>
 #include <dbrt/tracker/fusion_tracker.h>
 #include <dbrt/tracker/fusion_tracker_factory.h>
 #include <dbrt/tracker/robot_tracker.h>
@@ -88,6 +89,21 @@ std::shared_ptr<dbrt::FusionTracker> create_fusion_tracker(
     /* - tracker publisher          - */
     /* ------------------------------ */
 
+    // If the camera offset is estimated at a positive rate, it is refined by
+    // a separate estimator and the per frame visual tracker only samples the
+    // joints
+    bool estimate_camera_offset =
+        ri::read<bool>("camera_offset/estimate_camera_offset", nh);
+    double camera_offset_estimation_rate =
+        nh.param<double>("camera_offset/estimation_rate", 1.0);
+    bool separate_camera_offset_estimation =
+        estimate_camera_offset && camera_offset_estimation_rate > 0.;
+
+    // The visual tracker and the camera offset estimator create their
+    // trackers on their own threads. Loading the meshes modifies the shared
+    // kinematics, so the robot model is loaded once here and shared.
+    auto object_model = dbrt::create_robot_model(prefix, kinematics);
+
     auto fusion_tracker = std::make_shared<dbrt::FusionTracker>(
         camera_data,
         kinematics,
@@ -96,12 +112,36 @@ std::shared_ptr<dbrt::FusionTracker> create_fusion_tracker(
         },
         [=]() {
             return dbrt::create_visual_tracker(
-                prefix, kinematics, camera_data, joint_state);
+                prefix,
+                kinematics,
+                object_model,
+                camera_data,
+                joint_state,
+                separate_camera_offset_estimation
+                    ? CameraOffsetSampling::Never
+                    : CameraOffsetSampling::WithJoints);
         },
         ri::read<double>(prefix + "camera_delay", nh));
 
     fusion_tracker->initialize(initial_states);
 
+    if (separate_camera_offset_estimation)
+    {
+        fusion_tracker->camera_offset_estimator(
+            std::make_shared<CameraOffsetEstimator>(
+                [=]() {
+                    return dbrt::create_visual_tracker(
+                        prefix,
+                        kinematics,
+                        object_model,
+                        camera_data,
+                        joint_state,
+                        CameraOffsetSampling::Only);
+                },
+                kinematics,
+                camera_offset_estimation_rate));
+    }
+
     return fusion_tracker;
 }
 }
@@ -63,7 +63,6 @@ int main(int argc, char** argv)
     /* ------------------------------ */
     auto kinematics = dbrt::create_kinematics(nh, camera_data->frame_id());
     dbrt::RobotState<>::kinematics_ = kinematics;
-    dbrt::RobotState<>::kinematics_mutex_ = std::make_shared<std::mutex>();
 
     /* ------------------------------ */
     /* - Initial states               */
@@ -113,13 +112,13 @@ int main(int argc, char** argv)
     spinner.start();
 
     ros::Rate visualization_rate(100);
+    State current_state;
+    double current_time;
+    dbrt::JointsObsrv current_angle_measurement;
     while (ros::ok())
     {
         visualization_rate.sleep();
 
-        State current_state;
-        double current_time;
-        dbrt::JointsObsrv current_angle_measurement;
         fusion_tracker->current_things(
             current_state, current_time, current_angle_measurement);
 
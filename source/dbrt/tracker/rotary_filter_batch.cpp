@@ -0,0 +1,309 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file rotary_filter_batch.cpp
+ * \date October 2026
+ */
+
+#include <cmath>
+#include <dbrt/tracker/rotary_filter_batch.h>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace dbrt
+{
+// number of doubles processed by one vector instruction
+static const int batch_width = 4;
+
+RotaryFilterBatch::RotaryFilterBatch(int joint_count)
+    : joint_count_(joint_count),
+      padded_count_((joint_count + batch_width - 1) / batch_width *
+                    batch_width),
+      m0_(padded_count_, 0.),
+      m1_(padded_count_, 0.),
+      p00_(padded_count_, 0.),
+      p01_(padded_count_, 0.),
+      p11_(padded_count_, 0.),
+      a00_(padded_count_, 1.),
+      a01_(padded_count_, 0.),
+      a10_(padded_count_, 0.),
+      a11_(padded_count_, 1.),
+      q00_(padded_count_, 0.),
+      q01_(padded_count_, 0.),
+      q11_(padded_count_, 0.),
+      h0_(padded_count_, 0.),
+      h1_(padded_count_, 0.),
+      r_(padded_count_, 1.),
+      z_(padded_count_, 0.),
+      k0_(padded_count_, 0.),
+      k1_(padded_count_, 0.),
+#ifdef __AVX2__
+      vector_instructions_(true),
+#else
+      vector_instructions_(false),
+#endif
+      steady_state_tolerance_(0.),
+      steady_state_(false)
+{
+    // the padding joints have identity dynamics, no noise and a sensor which
+    // does not observe anything, so they stay finite and never change
+}
+
+void RotaryFilterBatch::set_joint_model(int joint,
+                                        const Eigen::Matrix2d& dynamics,
+                                        const Eigen::Matrix2d& noise_covariance,
+                                        const Eigen::RowVector2d& sensor,
+                                        double sensor_variance)
+{
+    a00_[joint] = dynamics(0, 0);
+    a01_[joint] = dynamics(0, 1);
+    a10_[joint] = dynamics(1, 0);
+    a11_[joint] = dynamics(1, 1);
+
+    q00_[joint] = noise_covariance(0, 0);
+    q01_[joint] = noise_covariance(0, 1);
+    q11_[joint] = noise_covariance(1, 1);
+
+    h0_[joint] = sensor(0);
+    h1_[joint] = sensor(1);
+    r_[joint] = sensor_variance;
+
+    reset_steady_state();
+}
+
+void RotaryFilterBatch::steady_state_tolerance(double tolerance)
+{
+    steady_state_tolerance_ = tolerance;
+    reset_steady_state();
+
+    if (steady_state_tolerance_ > 0.)
+    {
+        prev_p00_.resize(padded_count_);
+        prev_p01_.resize(padded_count_);
+        prev_p11_.resize(padded_count_);
+    }
+}
+
+void RotaryFilterBatch::vector_instructions(bool enabled)
+{
+#ifdef __AVX2__
+    vector_instructions_ = enabled;
+#endif
+}
+
+void RotaryFilterBatch::set_belief(int joint,
+                                   const Eigen::Vector2d& mean,
+                                   const Eigen::Matrix2d& covariance)
+{
+    m0_[joint] = mean(0);
+    m1_[joint] = mean(1);
+    p00_[joint] = covariance(0, 0);
+    p01_[joint] = covariance(0, 1);
+    p11_[joint] = covariance(1, 1);
+
+    reset_steady_state();
+}
+
+void RotaryFilterBatch::belief(int joint,
+                               Eigen::Vector2d& mean,
+                               Eigen::Matrix2d& covariance) const
+{
+    mean(0) = m0_[joint];
+    mean(1) = m1_[joint];
+    covariance(0, 0) = p00_[joint];
+    covariance(0, 1) = p01_[joint];
+    covariance(1, 0) = p01_[joint];
+    covariance(1, 1) = p11_[joint];
+}
+
+void RotaryFilterBatch::predict_and_update(
+    const Eigen::Ref<const Eigen::VectorXd>& obsrv)
+{
+    for (int i = 0; i < joint_count_; ++i)
+    {
+        z_[i] = obsrv(i);
+    }
+
+    if (steady_state_)
+    {
+        predict_and_update_steady_state(0, padded_count_);
+        return;
+    }
+
+    if (steady_state_tolerance_ > 0.)
+    {
+        prev_p00_ = p00_;
+        prev_p01_ = p01_;
+        prev_p11_ = p11_;
+    }
+
+#ifdef __AVX2__
+    if (vector_instructions_)
+    {
+        predict_and_update_avx2(0, padded_count_);
+    }
+    else
+    {
+        predict_and_update_scalar(0, padded_count_);
+    }
+#else
+    predict_and_update_scalar(0, padded_count_);
+#endif
+
+    if (steady_state_tolerance_ > 0.)
+    {
+        steady_state_ = covariances_converged();
+    }
+}
+
+void RotaryFilterBatch::predict_and_update_steady_state(int begin, int end)
+{
+    // the covariances stay at their fixed point, so the update reduces to
+    // m = A m + K (z - H A m)
+    for (int i = begin; i < end; ++i)
+    {
+        const double m0 = a00_[i] * m0_[i] + a01_[i] * m1_[i];
+        const double m1 = a10_[i] * m0_[i] + a11_[i] * m1_[i];
+        const double innovation = z_[i] - (h0_[i] * m0 + h1_[i] * m1);
+
+        m0_[i] = m0 + k0_[i] * innovation;
+        m1_[i] = m1 + k1_[i] * innovation;
+    }
+}
+
+bool RotaryFilterBatch::covariances_converged() const
+{
+    for (int i = 0; i < joint_count_; ++i)
+    {
+        if (std::fabs(p00_[i] - prev_p00_[i]) >
+                steady_state_tolerance_ * (1. + std::fabs(p00_[i])) ||
+            std::fabs(p01_[i] - prev_p01_[i]) >
+                steady_state_tolerance_ * (1. + std::fabs(p01_[i])) ||
+            std::fabs(p11_[i] - prev_p11_[i]) >
+                steady_state_tolerance_ * (1. + std::fabs(p11_[i])))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void RotaryFilterBatch::predict_and_update_scalar(int begin, int end)
+{
+    for (int i = begin; i < end; ++i)
+    {
+        // predict: m = A m, P = A P A^T + Q
+        const double m0 = a00_[i] * m0_[i] + a01_[i] * m1_[i];
+        const double m1 = a10_[i] * m0_[i] + a11_[i] * m1_[i];
+
+        const double t00 = a00_[i] * p00_[i] + a01_[i] * p01_[i];
+        const double t01 = a00_[i] * p01_[i] + a01_[i] * p11_[i];
+        const double t10 = a10_[i] * p00_[i] + a11_[i] * p01_[i];
+        const double t11 = a10_[i] * p01_[i] + a11_[i] * p11_[i];
+
+        const double p00 = t00 * a00_[i] + t01 * a01_[i] + q00_[i];
+        const double p01 = t00 * a10_[i] + t01 * a11_[i] + q01_[i];
+        const double p11 = t10 * a10_[i] + t11 * a11_[i] + q11_[i];
+
+        // update: u = P H^T, s = H u + r, K = u / s
+        const double u0 = p00 * h0_[i] + p01 * h1_[i];
+        const double u1 = p01 * h0_[i] + p11 * h1_[i];
+        const double s = h0_[i] * u0 + h1_[i] * u1 + r_[i];
+        const double k0 = u0 / s;
+        const double k1 = u1 / s;
+        const double innovation = z_[i] - (h0_[i] * m0 + h1_[i] * m1);
+
+        k0_[i] = k0;
+        k1_[i] = k1;
+        m0_[i] = m0 + k0 * innovation;
+        m1_[i] = m1 + k1 * innovation;
+        p00_[i] = p00 - k0 * u0;
+        p01_[i] = p01 - k0 * u1;
+        p11_[i] = p11 - k1 * u1;
+    }
+}
+
+#ifdef __AVX2__
+void RotaryFilterBatch::predict_and_update_avx2(int begin, int end)
+{
+    for (int i = begin; i < end; i += batch_width)
+    {
+        const __m256d a00 = _mm256_loadu_pd(&a00_[i]);
+        const __m256d a01 = _mm256_loadu_pd(&a01_[i]);
+        const __m256d a10 = _mm256_loadu_pd(&a10_[i]);
+        const __m256d a11 = _mm256_loadu_pd(&a11_[i]);
+        const __m256d h0 = _mm256_loadu_pd(&h0_[i]);
+        const __m256d h1 = _mm256_loadu_pd(&h1_[i]);
+
+        const __m256d m0_prior = _mm256_loadu_pd(&m0_[i]);
+        const __m256d m1_prior = _mm256_loadu_pd(&m1_[i]);
+        const __m256d p00_prior = _mm256_loadu_pd(&p00_[i]);
+        const __m256d p01_prior = _mm256_loadu_pd(&p01_[i]);
+        const __m256d p11_prior = _mm256_loadu_pd(&p11_[i]);
+
+        // predict: m = A m, P = A P A^T + Q
+        const __m256d m0 = _mm256_add_pd(_mm256_mul_pd(a00, m0_prior),
+                                         _mm256_mul_pd(a01, m1_prior));
+        const __m256d m1 = _mm256_add_pd(_mm256_mul_pd(a10, m0_prior),
+                                         _mm256_mul_pd(a11, m1_prior));
+
+        const __m256d t00 = _mm256_add_pd(_mm256_mul_pd(a00, p00_prior),
+                                          _mm256_mul_pd(a01, p01_prior));
+        const __m256d t01 = _mm256_add_pd(_mm256_mul_pd(a00, p01_prior),
+                                          _mm256_mul_pd(a01, p11_prior));
+        const __m256d t10 = _mm256_add_pd(_mm256_mul_pd(a10, p00_prior),
+                                          _mm256_mul_pd(a11, p01_prior));
+        const __m256d t11 = _mm256_add_pd(_mm256_mul_pd(a10, p01_prior),
+                                          _mm256_mul_pd(a11, p11_prior));
+
+        const __m256d p00 = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(t00, a00), _mm256_mul_pd(t01, a01)),
+            _mm256_loadu_pd(&q00_[i]));
+        const __m256d p01 = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(t00, a10), _mm256_mul_pd(t01, a11)),
+            _mm256_loadu_pd(&q01_[i]));
+        const __m256d p11 = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(t10, a10), _mm256_mul_pd(t11, a11)),
+            _mm256_loadu_pd(&q11_[i]));
+
+        // update: u = P H^T, s = H u + r, K = u / s
+        const __m256d u0 =
+            _mm256_add_pd(_mm256_mul_pd(p00, h0), _mm256_mul_pd(p01, h1));
+        const __m256d u1 =
+            _mm256_add_pd(_mm256_mul_pd(p01, h0), _mm256_mul_pd(p11, h1));
+        const __m256d s = _mm256_add_pd(
+            _mm256_add_pd(_mm256_mul_pd(h0, u0), _mm256_mul_pd(h1, u1)),
+            _mm256_loadu_pd(&r_[i]));
+        const __m256d k0 = _mm256_div_pd(u0, s);
+        const __m256d k1 = _mm256_div_pd(u1, s);
+        const __m256d innovation = _mm256_sub_pd(
+            _mm256_loadu_pd(&z_[i]),
+            _mm256_add_pd(_mm256_mul_pd(h0, m0), _mm256_mul_pd(h1, m1)));
+
+        _mm256_storeu_pd(&k0_[i], k0);
+        _mm256_storeu_pd(&k1_[i], k1);
+        _mm256_storeu_pd(&m0_[i],
+                         _mm256_add_pd(m0, _mm256_mul_pd(k0, innovation)));
+        _mm256_storeu_pd(&m1_[i],
+                         _mm256_add_pd(m1, _mm256_mul_pd(k1, innovation)));
+        _mm256_storeu_pd(&p00_[i], _mm256_sub_pd(p00, _mm256_mul_pd(k0, u0)));
+        _mm256_storeu_pd(&p01_[i], _mm256_sub_pd(p01, _mm256_mul_pd(k0, u1)));
+        _mm256_storeu_pd(&p11_[i], _mm256_sub_pd(p11, _mm256_mul_pd(k1, u1)));
+    }
+}
+#endif
+}
@@ -0,0 +1,158 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file rotary_filter_batch.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <vector>
+
+namespace dbrt
+{
+/**
+ * \brief Kalman filters of all rotary joints evaluated in one pass.
+ *
+ * Every joint has a two dimensional state (angle and bias), a linear
+ * transition x' = A x + w with w ~ N(0, Q) and a scalar linear sensor
+ * y = H x + v with v ~ N(0, r). These are the same models the per joint
+ * fl::GaussianFilter instances use.
+ *
+ * Means, covariances and model parameters of all joints are stored in
+ * struct-of-arrays layout such that predict and update of several joints are
+ * computed with the same vector instructions. The AVX2 path is used if the
+ * library is compiled with AVX2 enabled (DBRT_USE_AVX2), otherwise a scalar
+ * loop is used. The arrays are padded to a multiple of the vector width with
+ * neutral joints.
+ *
+ * Since the models are time invariant, the covariances and gains converge to
+ * a fixed point. If a steady state tolerance is set, the batch detects this
+ * and from then on only propagates the means with the converged gains. Any
+ * change of the beliefs from outside has to be followed by
+ * reset_steady_state() to return to the full update until convergence.
+ */
+class RotaryFilterBatch
+{
+public:
+    explicit RotaryFilterBatch(int joint_count);
+
+    /**
+     * \brief Sets the models of a single joint
+     *
+     * \param dynamics           2x2 transition matrix A
+     * \param noise_covariance   2x2 transition noise covariance Q
+     * \param sensor             1x2 sensor matrix H
+     * \param sensor_variance    sensor noise variance r
+     */
+    void set_joint_model(int joint,
+                         const Eigen::Matrix2d& dynamics,
+                         const Eigen::Matrix2d& noise_covariance,
+                         const Eigen::RowVector2d& sensor,
+                         double sensor_variance);
+
+    /**
+     * \brief Runs predict and update of all joints given the joints
+     *        observation which must have joint_count() entries
+     */
+    void predict_and_update(const Eigen::Ref<const Eigen::VectorXd>& obsrv);
+
+    /**
+     * \brief Enables the steady state mode if tolerance is positive. The
+     *        filters are considered converged once no covariance entry
+     *        changes by more than tolerance * (1 + |entry|) within one step.
+     */
+    void steady_state_tolerance(double tolerance);
+    double steady_state_tolerance() const { return steady_state_tolerance_; }
+
+    /**
+     * \brief Returns true if the gains have converged and the mean only
+     *        update is being used
+     */
+    bool steady_state() const { return steady_state_; }
+
+    /**
+     * \brief Returns to the full covariance update. Has to be called whenever
+     *        the beliefs are modified through the array accessors.
+     */
+    void reset_steady_state() { steady_state_ = false; }
+
+    /**
+     * \brief Selects the AVX2 kernel of the full update if enabled, which is
+     *        the default, or the scalar kernel otherwise. Without
+     *        DBRT_USE_AVX2 the scalar kernel is always used.
+     */
+    void vector_instructions(bool enabled);
+    bool vector_instructions() const { return vector_instructions_; }
+
+    void set_belief(int joint,
+                    const Eigen::Vector2d& mean,
+                    const Eigen::Matrix2d& covariance);
+    void belief(int joint,
+                Eigen::Vector2d& mean,
+                Eigen::Matrix2d& covariance) const;
+
+    int joint_count() const { return joint_count_; }
+
+    // struct-of-arrays belief access. Each array holds one entry per joint.
+    const double* mean0() const { return m0_.data(); }
+    const double* mean1() const { return m1_.data(); }
+    const double* cov00() const { return p00_.data(); }
+    const double* cov01() const { return p01_.data(); }
+    const double* cov11() const { return p11_.data(); }
+    double* mean0() { return m0_.data(); }
+    double* mean1() { return m1_.data(); }
+    double* cov00() { return p00_.data(); }
+    double* cov01() { return p01_.data(); }
+    double* cov11() { return p11_.data(); }
+
+private:
+    void predict_and_update_scalar(int begin, int end);
+#ifdef __AVX2__
+    void predict_and_update_avx2(int begin, int end);
+#endif
+    void predict_and_update_steady_state(int begin, int end);
+    bool covariances_converged() const;
+
+private:
+    int joint_count_;
+    int padded_count_;
+
+    // beliefs
+    std::vector<double> m0_, m1_;
+    std::vector<double> p00_, p01_, p11_;
+
+    // transition
+    std::vector<double> a00_, a01_, a10_, a11_;
+    std::vector<double> q00_, q01_, q11_;
+
+    // sensor
+    std::vector<double> h0_, h1_, r_;
+
+    // padded copy of the current observation
+    std::vector<double> z_;
+
+    // Kalman gains of the last full update
+    std::vector<double> k0_, k1_;
+
+    // kernel selection of the full update
+    bool vector_instructions_;
+
+    // steady state detection
+    double steady_state_tolerance_;
+    bool steady_state_;
+    std::vector<double> prev_p00_, prev_p01_, prev_p11_;
+};
+}
@@ -19,34 +19,90 @@
 
 #include <Eigen/Core>
 #include <dbrt/tracker/rotary_tracker.h>
+#include <ros/ros.h>
 
 namespace dbrt
 {
 RotaryTracker::RotaryTracker(
     const std::shared_ptr<std::vector<JointFilter>>& joint_filters,
+    const std::shared_ptr<RotaryFilterBatch>& filter_batch,
     const std::shared_ptr<KinematicsFromURDF>& kinematics)
-    : joint_filters_(joint_filters), kinematics_(kinematics)
+    : joint_filters_(joint_filters),
+      filter_batch_(filter_batch),
+      kinematics_(kinematics),
+      camera_offset_version_(0)
 {
+    const int camera_offset_dim =
+        kinematics_->num_joints() - filter_batch_->joint_count();
+    camera_offset_.setZero(camera_offset_dim);
+    camera_offset_variance_.setZero(camera_offset_dim);
 }
 
 void RotaryTracker::track_callback(const sensor_msgs::JointState& joint_msg)
 {
-    track(kinematics_->sensor_msg_to_eigen(joint_msg));
+    Obsrv obsrv;
+    if (!kinematics_->sensor_msg_to_eigen(joint_msg, obsrv))
+    {
+        ROS_ERROR_THROTTLE(1.0,
+                           "Skipping a joint state message which does not "
+                           "contain all robot joints");
+        return;
+    }
+
+    track(obsrv);
 }
 
 const std::vector<RotaryTracker::JointBelief>& RotaryTracker::beliefs() const
 {
+    if (beliefs_.size() != joint_filters_->size())
+    {
+        beliefs_.resize(joint_filters_->size());
+        for (int i = 0; i < beliefs_.size(); i++)
+        {
+            beliefs_[i] = (*joint_filters_)[i].create_belief();
+        }
+    }
+
+    for (int i = 0; i < beliefs_.size(); i++)
+    {
+        auto mean = beliefs_[i].mean();
+        auto cov = beliefs_[i].covariance();
+        mean(0) = filter_batch_->mean0()[i];
+        mean(1) = filter_batch_->mean1()[i];
+        cov(0, 0) = filter_batch_->cov00()[i];
+        cov(0, 1) = filter_batch_->cov01()[i];
+        cov(1, 0) = filter_batch_->cov01()[i];
+        cov(1, 1) = filter_batch_->cov11()[i];
+
+        beliefs_[i].mean(mean);
+        beliefs_[i].covariance(cov);
+    }
+
     return beliefs_;
 }
 
 std::vector<RotaryTracker::AngleBelief> RotaryTracker::angle_beliefs()
 {
-    std::vector<AngleBelief> beliefs(beliefs_.size());
+    const int joint_count = filter_batch_->joint_count();
+    std::vector<AngleBelief> beliefs(joint_count + camera_offset_.size());
 
     for (int i = 0; i < beliefs.size(); i++)
     {
-        beliefs[i].mean(beliefs_[i].mean().middleRows(0, 1));
-        beliefs[i].covariance(beliefs_[i].covariance().block(0, 0, 1, 1));
+        auto mean = beliefs[i].mean();
+        auto cov = beliefs[i].covariance();
+        if (i < joint_count)
+        {
+            mean(0) = filter_batch_->mean0()[i];
+            cov(0, 0) = filter_batch_->cov00()[i];
+        }
+        else
+        {
+            mean(0) = camera_offset_(i - joint_count);
+            cov(0, 0) = camera_offset_variance_(i - joint_count);
+        }
+
+        beliefs[i].mean(mean);
+        beliefs[i].covariance(cov);
     }
 
     return beliefs;
@@ -55,47 +111,137 @@ std::vector<RotaryTracker::AngleBelief> RotaryTracker::angle_beliefs()
 void RotaryTracker::set_angle_beliefs(
     std::vector<RotaryTracker::AngleBelief> angle_beliefs)
 {
-    if (beliefs_.size() != angle_beliefs.size())
+    const int joint_count = filter_batch_->joint_count();
+    if (joint_count + camera_offset_.size() != angle_beliefs.size())
     {
         std::cout << "your beliefs have the wrong size!" << std::endl;
         exit(-1);
     }
 
-    for (int i = 0; i < beliefs_.size(); i++)
-    {
-        auto mean = beliefs_[i].mean();
-        auto cov = beliefs_[i].covariance();
+    double* mean0 = filter_batch_->mean0();
+    double* mean1 = filter_batch_->mean1();
+    double* cov00 = filter_batch_->cov00();
+    double* cov01 = filter_batch_->cov01();
+    double* cov11 = filter_batch_->cov11();
 
+    for (int i = 0; i < joint_count; i++)
+    {
         // the parameters of the conditional p(b|a) = N(b|Ma + m, C)
-        fl::Real M = cov(0, 1) / cov(0, 0);
-        fl::Real m = mean(1) - M * mean(0);
-        fl::Real C = cov(1, 1) - cov(1, 0) / cov(0, 0) * cov(0, 1);
-
-        auto mean_y = mean;
-        auto cov_y = cov;
-        mean_y(0) = angle_beliefs[i].mean()(0);
-        cov_y(0, 0) = angle_beliefs[i].covariance()(0, 0);
+        fl::Real M = cov01[i] / cov00[i];
+        fl::Real m = mean1[i] - M * mean0[i];
+        fl::Real C = cov11[i] - cov01[i] / cov00[i] * cov01[i];
 
         // put the new marginal and the conditional together to form the joint
-        mean_y(1) = M * mean_y(0) + m;
-        cov_y(0, 1) = M * cov_y(0, 0);
-        cov_y(1, 0) = cov_y(0, 1);
-        cov_y(1, 1) = C + M * cov_y(0, 0) * M;
+        mean0[i] = angle_beliefs[i].mean()(0);
+        cov00[i] = angle_beliefs[i].covariance()(0, 0);
+        mean1[i] = M * mean0[i] + m;
+        cov01[i] = M * cov00[i];
+        cov11[i] = C + M * cov00[i] * M;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < camera_offset_.size(); i++)
+        {
+            camera_offset_(i) = angle_beliefs[joint_count + i].mean()(0);
+            camera_offset_variance_(i) =
+                angle_beliefs[joint_count + i].covariance()(0, 0);
+        }
 
-        beliefs_[i].mean(mean_y);
-        beliefs_[i].covariance(cov_y);
+        apply_published_camera_offset();
     }
+
+    // the correction moves the covariances away from their fixed point
+    filter_batch_->reset_steady_state();
 }
 
 void RotaryTracker::set_beliefs(
     const std::vector<RotaryTracker::JointBelief>& beliefs)
 {
-    beliefs_ = beliefs;
+    for (int i = 0; i < beliefs.size(); i++)
+    {
+        filter_batch_->set_belief(
+            i, beliefs[i].mean(), beliefs[i].covariance());
+    }
 }
 
-std::vector<RotaryTracker::JointBelief>& RotaryTracker::beliefs()
+void RotaryTracker::set_beliefs(
+    const Eigen::Ref<const Eigen::VectorXd>& snapshot)
 {
-    return beliefs_;
+    double* mean0 = filter_batch_->mean0();
+    double* mean1 = filter_batch_->mean1();
+    double* cov00 = filter_batch_->cov00();
+    double* cov01 = filter_batch_->cov01();
+    double* cov11 = filter_batch_->cov11();
+
+    for (int i = 0; i < filter_batch_->joint_count(); i++)
+    {
+        const int offset = i * JointSnapshotDim;
+
+        mean0[i] = snapshot(offset);
+        mean1[i] = snapshot(offset + 1);
+        cov00[i] = snapshot(offset + 2);
+        cov01[i] = snapshot(offset + 3);
+        cov11[i] = snapshot(offset + 4);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (int i = 0; i < camera_offset_.size(); i++)
+        {
+            const int offset =
+                (filter_batch_->joint_count() + i) * JointSnapshotDim;
+
+            camera_offset_(i) = snapshot(offset);
+            camera_offset_variance_(i) = snapshot(offset + 2);
+        }
+
+        apply_published_camera_offset();
+    }
+    filter_batch_->reset_steady_state();
+}
+
+void RotaryTracker::beliefs_snapshot(Eigen::Ref<Eigen::VectorXd> snapshot) const
+{
+    const double* mean0 = filter_batch_->mean0();
+    const double* mean1 = filter_batch_->mean1();
+    const double* cov00 = filter_batch_->cov00();
+    const double* cov01 = filter_batch_->cov01();
+    const double* cov11 = filter_batch_->cov11();
+
+    for (int i = 0; i < filter_batch_->joint_count(); i++)
+    {
+        const int offset = i * JointSnapshotDim;
+
+        snapshot(offset) = mean0[i];
+        snapshot(offset + 1) = mean1[i];
+        snapshot(offset + 2) = cov00[i];
+        snapshot(offset + 3) = cov01[i];
+        snapshot(offset + 4) = cov11[i];
+    }
+
+    for (int i = 0; i < camera_offset_.size(); i++)
+    {
+        const int offset =
+            (filter_batch_->joint_count() + i) * JointSnapshotDim;
+
+        snapshot(offset) = camera_offset_(i);
+        snapshot(offset + 1) = 0;
+        snapshot(offset + 2) = camera_offset_variance_(i);
+        snapshot(offset + 3) = 0;
+        snapshot(offset + 4) = 0;
+    }
+}
+
+int RotaryTracker::snapshot_size() const
+{
+    return (filter_batch_->joint_count() + camera_offset_.size()) *
+           JointSnapshotDim;
+}
+
+void RotaryTracker::steady_state_tolerance(double tolerance)
+{
+    filter_batch_->steady_state_tolerance(tolerance);
 }
 
 RobotTracker::State RotaryTracker::current_state() const
@@ -104,53 +250,78 @@ RobotTracker::State RotaryTracker::current_state() const
     return current_state_;
 }
 
+Eigen::VectorXd RotaryTracker::camera_offset() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return camera_offset_;
+}
+
+// expects mutex_ to be held
+void RotaryTracker::apply_published_camera_offset()
+{
+    if (camera_offset_.size() == 0) return;
+
+    // a single atomic load unless a new offset has been published
+    const std::uint64_t version = kinematics_->camera_offset_version();
+    if (version == 0) return;
+    if (version != camera_offset_version_)
+    {
+        published_camera_offset_ = kinematics_->camera_offset();
+        camera_offset_version_ = version;
+    }
+
+    // the published offset is the estimate, it is not uncertain in here
+    camera_offset_ = published_camera_offset_;
+    camera_offset_variance_.setZero();
+}
+
 /// todo: there should be no obsrv passed in this function
 void RotaryTracker::initialize(const std::vector<State>& initial_states)
 {
-    State state;
-    state.resize(joint_filters_->size());
+    const int joint_count = filter_batch_->joint_count();
 
-    beliefs_.resize(joint_filters_->size());
+    State state;
+    state.resize(joint_count + camera_offset_.size());
 
-    for (int i = 0; i < joint_filters_->size(); ++i)
+    for (int i = 0; i < joint_count; ++i)
     {
-        beliefs_[i] = (*joint_filters_)[i].create_belief();
-
-        auto cov = beliefs_[i].covariance();
-        cov.setZero();
-        auto mean = beliefs_[i].mean();
-        mean.setZero();
+        JointState mean = JointState::Zero();
         mean(0) = initial_states[0](i);
 
-        beliefs_[i].mean(mean);
-        beliefs_[i].covariance(cov);
+        filter_batch_->set_belief(i, mean, Eigen::Matrix2d::Zero());
 
-        state(i) = beliefs_[i].mean()(0);
+        state(i) = mean(0);
     }
 
     std::lock_guard<std::mutex> lock(mutex_);
+    camera_offset_ = initial_states[0].tail(camera_offset_.size());
+    camera_offset_variance_.setZero();
+    state.tail(camera_offset_.size()) = camera_offset_;
     current_state_ = state;
 }
 
 auto RotaryTracker::track(const Obsrv& joints_obsrv) -> State
 {
     State state;
-    state.resize(joint_filters_->size());
+    track(joints_obsrv, state);
 
-    for (int i = 0; i < joint_filters_->size(); ++i)
-    {
-        (*joint_filters_)[i].predict(
-            beliefs_[i], JointInput::Zero(), beliefs_[i]);
+    return state;
+}
 
-        (*joint_filters_)[i].update(
-            beliefs_[i], joints_obsrv.middleRows(i, 1), beliefs_[i]);
+void RotaryTracker::track(const Obsrv& joints_obsrv, State& state)
+{
+    // predict and update all joint filters in a single batched pass
+    filter_batch_->predict_and_update(joints_obsrv);
 
-        state(i) = beliefs_[i].mean()(0);
-    }
+    const int joint_count = filter_batch_->joint_count();
+    state.resize(joint_count + camera_offset_.size());
+    state.head(joint_count) =
+        Eigen::Map<const Eigen::VectorXd>(filter_batch_->mean0(), joint_count);
 
-    //    std::lock_guard<std::mutex> lock(mutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
+    apply_published_camera_offset();
+    state.tail(camera_offset_.size()) = camera_offset_;
+    state.invalidate_link_poses();
     current_state_ = state;
-
-    return state;
 }
 }
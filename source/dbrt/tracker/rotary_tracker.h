@@ -21,6 +21,7 @@
 
 #include <dbrt/kinematics_from_urdf.h>
 #include <dbrt/tracker/robot_tracker.h>
+#include <dbrt/tracker/rotary_filter_batch.h>
 #include <fl/filter/gaussian/gaussian_filter_linear.hpp>
 #include <fl/model/sensor/linear_gaussian_sensor.hpp>
 #include <fl/model/transition/interface/transition_function.hpp>
@@ -43,6 +44,9 @@ public:
         JointNoiseDim = 2,
         JointObsrvDim = 1,
         JointInputDim = 1,
+        // compact belief snapshot of a single joint: the mean followed by the
+        // unique covariance entries (0, 0), (0, 1) and (1, 1)
+        JointSnapshotDim = 5
     };
 
     // single joint filter
@@ -68,8 +72,21 @@ public:
     typedef fl::Gaussian<Eigen::Matrix<fl::Real, 1, 1>> AngleBelief;
 
 public:
+    /**
+     * \brief Creates the tracker
+     *
+     * \param joint_filters
+     *     Per joint filters. These define the belief representation.
+     * \param filter_batch
+     *     Batched filters with the same models as joint_filters which perform
+     *     the actual filtering of all joints
+     * \param kinematics
+     *     Robot kinematics. The state has kinematics->num_joints() entries,
+     *     the robot joints followed by the camera offset if it is estimated.
+     */
     RotaryTracker(
         const std::shared_ptr<std::vector<JointFilter>>& joint_filters,
+        const std::shared_ptr<RotaryFilterBatch>& filter_batch,
         const std::shared_ptr<KinematicsFromURDF>& kinematics);
 
     /**
@@ -80,6 +97,12 @@ public:
      */
     State track(const Obsrv& joints_obsrv);
 
+    /**
+     * \brief perform a single filter step and write the resulting state into
+     *        the given state. Does not allocate once state has the right size.
+     */
+    void track(const Obsrv& joints_obsrv, State& state);
+
     /**
      * \brief Initializes the particle filter with the given initial states and
      *    the number of evaluations
@@ -106,30 +129,77 @@ public:
     void set_beliefs(const std::vector<JointBelief>& beliefs);
 
     /**
-     * \brief Returns immutable reference to all joint belliefs
+     * \brief Restores all joint beliefs from a compact snapshot as written by
+     *        beliefs_snapshot()
+     */
+    void set_beliefs(const Eigen::Ref<const Eigen::VectorXd>& snapshot);
+
+    /**
+     * \brief Writes a compact snapshot of all joint beliefs into the given
+     *        vector which must have snapshot_size() entries. The snapshot
+     *        contains JointSnapshotDim values per state entry. The camera
+     *        offset entries store their mean and variance in the layout of a
+     *        joint without bias.
+     */
+    void beliefs_snapshot(Eigen::Ref<Eigen::VectorXd> snapshot) const;
+
+    /**
+     * \brief Size of the compact belief snapshot of all joints
+     */
+    int snapshot_size() const;
+
+    /**
+     * \brief Returns immutable reference to all joint belliefs. The beliefs
+     *        are assembled from the batched filters on each call.
      */
     const std::vector<JointBelief>& beliefs() const;
 
     /**
-     * \brief Returns mutable reference to all joint belliefs
+     * \brief Enables the steady state mode of the joint filters if the
+     *        tolerance is positive. Once the covariances have converged, only
+     *        the means are propagated with the converged gains until the
+     *        beliefs are set or corrected again.
      */
-    std::vector<JointBelief>& beliefs();
+    void steady_state_tolerance(double tolerance);
 
     /**
      * \brief Returns current state from the belief
      */
     State current_state() const;
 
+    /**
+     * \brief Current estimate of the camera offset x, y, z, pitch, yaw, roll
+     *        or an empty vector if the camera offset is not estimated.
+     *
+     * The camera offset is not observed by the joint sensors and therefore
+     * not filtered here. It takes the values of the last correction through
+     * set_angle_beliefs() and is appended to the tracked state. Once an
+     * offset has been published through KinematicsFromURDF::set_camera_offset
+     * the published offset is used instead.
+     */
+    Eigen::VectorXd camera_offset() const;
+
     /**
      * Callback function to apply the filter for the given joint state message
      */
     void track_callback(const sensor_msgs::JointState& joint_msg);
 
+private:
+    void apply_published_camera_offset();
+
 private:
     /* std::vector<int> joint_order_; */
     std::shared_ptr<KinematicsFromURDF> kinematics_;
     State current_state_;
-    std::vector<JointBelief> beliefs_;
+    mutable std::vector<JointBelief> beliefs_;
     std::shared_ptr<std::vector<JointFilter>> joint_filters_;
+    std::shared_ptr<RotaryFilterBatch> filter_batch_;
+    // mean and variance of the camera offset entries which follow the joints
+    // in the state
+    Eigen::VectorXd camera_offset_;
+    Eigen::VectorXd camera_offset_variance_;
+    // last published camera offset and its version
+    Eigen::VectorXd published_camera_offset_;
+    std::uint64_t camera_offset_version_;
 };
 }
@@ -44,19 +44,9 @@ std::shared_ptr<dbrt::RotaryTracker> create_rotary_tracker(
 
     typedef dbrt::RotaryTracker Tracker;
 
-    int joint_count = kinematics->num_joints();
-
-    bool estimate_camera_offset =
-        ri::read<bool>("camera_offset/estimate_camera_offset", nh);
-
-    auto camera_observation_joint_sigmas_map = read_maps_from_map_list(
-        "camera_offset/joint_observation/joint_sigmas", nh);
-    auto camera_transition_joint_sigmas_map = read_maps_from_map_list(
-        "camera_offset/joint_transition/joint_sigmas", nh);
-    auto camera_joint_bias_sigmas_map = read_maps_from_map_list(
-        "camera_offset/joint_transition/bias_sigmas", nh);
-    auto camera_joint_bias_factors_map = read_maps_from_map_list(
-        "camera_offset/joint_transition/bias_factors", nh);
+    // the camera offset is not observed by the joint sensors, only the robot
+    // joints are filtered
+    int joint_count = kinematics->num_robot_joints();
 
     /* ------------------------------ */
     /* - State transition function  - */
@@ -73,26 +63,6 @@ std::shared_ptr<dbrt::RotaryTracker> create_rotary_tracker(
     auto joint_bias_factors_map =
         read_maps_from_map_list(prefix + "joint_transition/bias_factors", nh);
 
-    if (estimate_camera_offset)
-    {
-        insert_map_with_prefixed_keys(
-            camera_transition_joint_sigmas_map,
-            kinematics->camera_frame_id() + "_",
-            transition_joint_sigmas_map);
-
-
-        insert_map_with_prefixed_keys(
-            camera_joint_bias_sigmas_map,
-            kinematics->camera_frame_id() + "_",
-            joint_bias_sigmas_map);
-
-
-        insert_map_with_prefixed_keys(
-            camera_joint_bias_factors_map,
-            kinematics->camera_frame_id() + "_",
-            joint_bias_factors_map);
-    }
-
     // linear state transition parameters
     transition_parameters.joint_sigmas =
         extract_ordered_values(transition_joint_sigmas_map, kinematics);
@@ -111,14 +81,6 @@ std::shared_ptr<dbrt::RotaryTracker> create_rotary_tracker(
     /* ------------------------------ */
     dbrt::RotarySensorBuilder<Tracker>::Parameters sensor_parameters;
 
-    if (estimate_camera_offset)
-    {
-        insert_map_with_prefixed_keys(
-            camera_observation_joint_sigmas_map,
-            kinematics->camera_frame_id() + "_",
-            observation_joint_sigmas_map);
-    }
-
     sensor_parameters.joint_sigmas =
         extract_ordered_values(observation_joint_sigmas_map, kinematics);
 
@@ -135,6 +97,10 @@ std::shared_ptr<dbrt::RotaryTracker> create_rotary_tracker(
 
     auto tracker = tracker_builder.build();
 
+    // optional, a non-positive tolerance keeps the full covariance update
+    tracker->steady_state_tolerance(
+        nh.param<double>(prefix + "joint_steady_state_tolerance", 0.0));
+
     /* ------------------------------ */
     /* - Initialize tracker         - */
     /* ------------------------------ */
@@ -59,7 +59,6 @@ int main(int argc, char** argv)
     /* - Few types we will be using - */
     /* ------------------------------ */
     dbrt::RobotState<>::kinematics_ = kinematics;
-    dbrt::RobotState<>::kinematics_mutex_ = std::make_shared<std::mutex>();
 
     // parameter shorthand prefix
     std::string pre = "";
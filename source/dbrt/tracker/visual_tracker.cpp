@@ -38,11 +38,14 @@ VisualTracker::VisualTracker(
     const std::shared_ptr<Filter>& filter,
     const std::shared_ptr<dbot::ObjectModel>& object_model,
     int evaluation_count,
-    int block_count)
+    int block_count,
+    const std::vector<int>& camera_offset_indices)
     : object_model_(object_model),
       filter_(filter),
       evaluation_count_(evaluation_count),
-      block_count_(block_count)
+      block_count_(block_count),
+      camera_offset_indices_(camera_offset_indices),
+      camera_offset_(Eigen::VectorXd::Zero(camera_offset_indices.size()))
 {
 }
 
@@ -63,6 +66,18 @@ auto VisualTracker::track(const Obsrv& image) -> State
 
     State mean = filter_->belief().mean();
 
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int i = 0; i < camera_offset_indices_.size(); ++i)
+    {
+        camera_offset_(i) = mean(camera_offset_indices_[i]);
+    }
+
     return mean;
 }
+
+Eigen::VectorXd VisualTracker::camera_offset() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return camera_offset_;
+}
 }
@@ -64,11 +64,16 @@ public:
      *     Camera data container
      * \param update_rate
      *     Moving average update rate
+     * \param camera_offset_indices
+     *     State indices of the camera offset x, y, z, pitch, yaw, roll if it
+     *     is estimated
      */
     VisualTracker(const std::shared_ptr<Filter>& filter,
                   const std::shared_ptr<dbot::ObjectModel>& object_model,
                   int evaluation_count,
-                  int block_count);
+                  int block_count,
+                  const std::vector<int>& camera_offset_indices =
+                      std::vector<int>());
 
     /**
      * \brief perform a single filter step
@@ -88,10 +93,18 @@ public:
 
     const std::shared_ptr<Filter> filter();
 
+    /**
+     * \brief Camera offset x, y, z, pitch, yaw, roll of the last estimate or
+     *        an empty vector if the camera offset is not estimated
+     */
+    Eigen::VectorXd camera_offset() const;
+
 private:
     std::shared_ptr<dbot::ObjectModel> object_model_;
     std::shared_ptr<Filter> filter_;
     int evaluation_count_;
     int block_count_;
+    std::vector<int> camera_offset_indices_;
+    Eigen::VectorXd camera_offset_;
 };
 }
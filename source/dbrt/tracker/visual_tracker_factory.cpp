@@ -34,9 +34,39 @@
 #include <dbrt/tracker/visual_tracker_factory.h>
 #include <dbrt/urdf_object_loader.h>
 #include <dbrt/util/parameter_tools.h>
+#include <map>
 
 namespace dbrt
 {
+std::shared_ptr<dbot::ObjectModel> create_robot_model(
+    std::string prefix,
+    std::shared_ptr<KinematicsFromURDF> kinematics)
+{
+    ros::NodeHandle nh("~");
+
+    auto object_model_loader =
+        std::make_shared<dbrt::UrdfObjectModelLoader>(kinematics);
+
+    // the rendered meshes may be coarser than the full resolution meshes
+    object_model_loader->triangle_budget(
+        nh.param<int>(prefix + "mesh/triangle_budget", 0));
+    std::map<std::string, int> link_triangle_budgets;
+    nh.getParam(prefix + "mesh/link_triangle_budgets", link_triangle_budgets);
+    for (const auto& link_budget : link_triangle_budgets)
+    {
+        object_model_loader->triangle_budget(link_budget.first,
+                                             link_budget.second);
+    }
+
+    // Load the model usign the URDF loader
+    auto object_model =
+        std::make_shared<dbot::ObjectModel>(object_model_loader, false);
+
+    ROS_INFO("Robot model loaded");
+
+    return object_model;
+}
+
 /**
  * \brief Create a particle filter tracking the robot joints based on depth
  *     images measurements
@@ -44,12 +74,31 @@ namespace dbrt
  *     parameter prefix, e.g. fusion_tracker
  * \param kinematics
  *     URDF robot kinematics
+ * \param camera_offset_sampling
+ *     Sampled part of the state if camera_offset/estimate_camera_offset is on
  */
 std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
     std::string prefix,
     std::shared_ptr<KinematicsFromURDF> kinematics,
     std::shared_ptr<dbot::CameraData> camera_data,
-    sensor_msgs::JointState::ConstPtr joint_state)
+    sensor_msgs::JointState::ConstPtr joint_state,
+    CameraOffsetSampling camera_offset_sampling)
+{
+    return create_visual_tracker(prefix,
+                                 kinematics,
+                                 create_robot_model(prefix, kinematics),
+                                 camera_data,
+                                 joint_state,
+                                 camera_offset_sampling);
+}
+
+std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
+    std::string prefix,
+    std::shared_ptr<KinematicsFromURDF> kinematics,
+    std::shared_ptr<dbot::ObjectModel> object_model,
+    std::shared_ptr<dbot::CameraData> camera_data,
+    sensor_msgs::JointState::ConstPtr joint_state,
+    CameraOffsetSampling camera_offset_sampling)
 {
     ros::NodeHandle nh("~");
 
@@ -62,18 +111,6 @@ std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
     auto camera_transition_joint_sigmas_map = read_maps_from_map_list(
         "camera_offset/joint_transition/joint_sigmas", nh);
 
-    /* ------------------------------ */
-    /* - Create the robot model     - */
-    /* ------------------------------ */
-    auto object_model_loader =
-        std::make_shared<dbrt::UrdfObjectModelLoader>(kinematics);
-
-    // Load the model usign the URDF loader
-    auto object_model = std::make_shared<dbot::ObjectModel>(
-        std::make_shared<dbrt::UrdfObjectModelLoader>(kinematics), false);
-
-    ROS_INFO("Robot model loaded");
-
     /* ------------------------------ */
     /* - State transition function  - */
     /* ------------------------------ */
@@ -91,6 +128,15 @@ std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
     // linear state transition parameters
     transition_parameters.joint_sigmas =
         extract_ordered_values(transition_joint_sigmas_map, kinematics);
+    if (estimate_camera_offset &&
+        camera_offset_sampling == CameraOffsetSampling::Only)
+    {
+        // the joints stay fixed while the camera offset is refined
+        for (int i = 0; i < kinematics->num_robot_joints(); ++i)
+        {
+            transition_parameters.joint_sigmas[i] = 0;
+        }
+    }
     ROS_INFO("Transition parameter loaded");
     transition_parameters.joint_count = kinematics->num_joints();
 
@@ -170,9 +216,24 @@ std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
 
     if (estimate_camera_offset)
     {
-        sampling_blocks_definition = merge_sampling_block_definitions(
-	   sampling_blocks_definition,
-           camera_offset_sampling_blocks_definition, kinematics->camera_frame_id() + '_');
+        switch (camera_offset_sampling)
+        {
+            case CameraOffsetSampling::WithJoints:
+                sampling_blocks_definition = merge_sampling_block_definitions(
+                    sampling_blocks_definition,
+                    camera_offset_sampling_blocks_definition,
+                    kinematics->camera_frame_id() + '_');
+                break;
+            case CameraOffsetSampling::Never:
+                // the camera offset entries of the state are left untouched
+                break;
+            case CameraOffsetSampling::Only:
+                sampling_blocks_definition = merge_sampling_block_definitions(
+                    SamplingBlocksDefinition(),
+                    camera_offset_sampling_blocks_definition,
+                    kinematics->camera_frame_id() + '_');
+                break;
+        }
     }
 
     tracker_parameters.sampling_blocks =
@@ -38,6 +38,19 @@
 
 namespace dbrt
 {
+/**
+ * \brief Which part of the state is sampled if the camera offset is estimated
+ */
+enum class CameraOffsetSampling
+{
+    // the camera offset is sampled together with the joints in every frame
+    WithJoints,
+    // only the joints are sampled, the camera offset is estimated separately
+    Never,
+    // only the camera offset is sampled, the joints remain fixed
+    Only
+};
+
 /**
  * \brief Create a particle filter tracking the robot joints based on depth
  *     images measurements
@@ -45,10 +58,38 @@ namespace dbrt
  *     parameter prefix, e.g. fusion_tracker
  * \param urdf_kinematics
  *     URDF robot kinematics
+ * \param camera_offset_sampling
+ *     Sampled part of the state if camera_offset/estimate_camera_offset is on
+ */
+std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
+    std::string prefix,
+    std::shared_ptr<KinematicsFromURDF> urdf_kinematics,
+    std::shared_ptr<dbot::CameraData> camera_data,
+    sensor_msgs::JointState::ConstPtr joint_state,
+    CameraOffsetSampling camera_offset_sampling =
+        CameraOffsetSampling::WithJoints);
+
+/**
+ * \brief Loads the robot meshes of urdf_kinematics into an object model.
+ *
+ * Loading the meshes rebuilds the mesh tables of urdf_kinematics, so it must
+ * not run concurrently with any other use of it. Trackers running on
+ * separate threads share one model created up front.
+ */
+std::shared_ptr<dbot::ObjectModel> create_robot_model(
+    std::string prefix,
+    std::shared_ptr<KinematicsFromURDF> urdf_kinematics);
+
+/**
+ * \brief Creates the tracker rendering the given robot model as created by
+ *        create_robot_model()
  */
 std::shared_ptr<dbrt::VisualTracker> create_visual_tracker(
     std::string prefix,
     std::shared_ptr<KinematicsFromURDF> urdf_kinematics,
+    std::shared_ptr<dbot::ObjectModel> object_model,
     std::shared_ptr<dbot::CameraData> camera_data,
-    sensor_msgs::JointState::ConstPtr joint_state);
+    sensor_msgs::JointState::ConstPtr joint_state,
+    CameraOffsetSampling camera_offset_sampling =
+        CameraOffsetSampling::WithJoints);
 }
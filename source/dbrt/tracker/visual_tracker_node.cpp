@@ -65,7 +65,6 @@ int main(int argc, char** argv)
     /* - Few types we will be using - */
     /* ------------------------------ */
     dbrt::RobotState<>::kinematics_ = kinematics;
-    dbrt::RobotState<>::kinematics_mutex_ = std::make_shared<std::mutex>();
     typedef dbrt::RobotState<> State;
 
     /* ------------------------------ */
@@ -121,6 +120,7 @@ int main(int argc, char** argv)
         tracker_ros.get_current_state(state, time);
 
         state[2] = 3;
+        state.invalidate_link_poses();
         tracker_publisher->publish_tf(state, time);
 
         ros::spinOnce();
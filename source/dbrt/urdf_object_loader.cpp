@@ -18,30 +18,119 @@
  */
 
 #include <ros/ros.h>
+#include <algorithm>
 #include <fl/util/profiling.hpp>
 #include <dbrt/urdf_object_loader.h>
+#include <dbrt/util/mesh_decimation.h>
+#include <dbrt/util/thread_pool.h>
 
 namespace dbrt
 {
 UrdfObjectModelLoader::UrdfObjectModelLoader(
-    const std::shared_ptr<KinematicsFromURDF>& urdf_kinematics)
-    : urdf_kinematics_(urdf_kinematics)
+    const std::shared_ptr<KinematicsFromURDF>& urdf_kinematics,
+    const std::string& mesh_cache_directory)
+    : urdf_kinematics_(urdf_kinematics), triangle_budget_(0)
 {
+    if (!mesh_cache_directory.empty())
+    {
+        mesh_cache_ = std::make_shared<MeshCache>(mesh_cache_directory);
+    }
+}
+
+void UrdfObjectModelLoader::triangle_budget(std::size_t budget)
+{
+    triangle_budget_ = budget;
+}
+
+void UrdfObjectModelLoader::triangle_budget(const std::string& link_name,
+                                            std::size_t budget)
+{
+    link_triangle_budgets_[link_name] = budget;
 }
 
 void UrdfObjectModelLoader::load(
     std::vector<std::vector<Eigen::Vector3d>>& vertices,
     std::vector<std::vector<std::vector<int>>>& triangle_indices) const
+{
+    auto meshes = std::make_shared<std::vector<PartMeshBuffers>>();
+    load(*meshes);
+
+    PartMeshBuffersLoader(meshes).load(vertices, triangle_indices);
+}
+
+void UrdfObjectModelLoader::load(std::vector<PartMeshBuffers>& meshes) const
 {
     std::vector<boost::shared_ptr<PartMeshModel>> part_meshes_;
     urdf_kinematics_->get_part_meshes(part_meshes_);
 
-    vertices.resize(part_meshes_.size());
-    triangle_indices.resize(part_meshes_.size());
-    for (size_t i = 0; i < part_meshes_.size(); i++)
+    meshes.resize(part_meshes_.size());
+
+    // returns true if the part has been read from the cache. The cache
+    // holds the full resolution meshes.
+    auto load_part = [&](std::size_t i) -> bool {
+        PartMeshModel& part = *part_meshes_[i];
+        bool cached = mesh_cache_ && mesh_cache_->read(part.get_mesh_path(),
+                                                       part.get_origin(),
+                                                       meshes[i]);
+        if (!cached)
+        {
+            meshes[i] = part.take_buffers();
+            if (mesh_cache_)
+            {
+                mesh_cache_->write(
+                    part.get_mesh_path(), part.get_origin(), meshes[i]);
+            }
+        }
+
+        auto link_budget = link_triangle_budgets_.find(part.get_name());
+        const std::size_t budget = link_budget != link_triangle_budgets_.end()
+                                       ? link_budget->second
+                                       : triangle_budget_;
+        if (budget > 0 && meshes[i].triangle_count() > budget)
+        {
+            meshes[i] = decimate_mesh(meshes[i], budget);
+            if (meshes[i].triangle_count() > budget)
+            {
+                ROS_WARN("The mesh of link %s keeps %d triangles at the "
+                         "coarsest decimation, exceeding its budget of %d",
+                         part.get_name().c_str(),
+                         int(meshes[i].triangle_count()),
+                         int(budget));
+            }
+        }
+        meshes[i].update_bounding_sphere();
+
+        return cached;
+    };
+
+    // each part writes its own entries only, so the output order does not
+    // depend on the order in which the parts finish
+    ThreadPool pool(
+        std::min(part_meshes_.size(), ThreadPool::default_size()));
+    auto from_cache = pool.map(part_meshes_.size(), load_part);
+
+    const int cached = std::count(from_cache.begin(), from_cache.end(), true);
+    ROS_INFO("Loaded %d of %d link meshes from the mesh cache",
+             cached,
+             int(part_meshes_.size()));
+}
+
+PartMeshBuffersLoader::PartMeshBuffersLoader(
+    const std::shared_ptr<const std::vector<PartMeshBuffers>>& meshes)
+    : meshes_(meshes)
+{
+}
+
+void PartMeshBuffersLoader::load(
+    std::vector<std::vector<Eigen::Vector3d>>& vertices,
+    std::vector<std::vector<std::vector<int>>>& triangle_indices) const
+{
+    vertices.resize(meshes_->size());
+    triangle_indices.resize(meshes_->size());
+    for (size_t i = 0; i < meshes_->size(); i++)
     {
-        vertices[i] = *(part_meshes_[i]->get_vertices());
-        triangle_indices[i] = *(part_meshes_[i]->get_indices());
+        vertices[i] = (*meshes_)[i].vertex_vectors();
+        triangle_indices[i] = (*meshes_)[i].triangle_vectors();
     }
 }
 }
@@ -20,8 +20,11 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <dbot/object_model_loader.h>
 #include <dbrt/kinematics_from_urdf.h>
+#include <dbrt/util/mesh_cache.h>
 
 namespace dbrt
 {
@@ -30,18 +33,69 @@ class UrdfObjectModelLoader : public dbot::ObjectModelLoader
 public:
     /**
      * \brief Creates a UrdfObjectModelLoader
+     *
+     * \param mesh_cache_directory
+     *     Directory of the transformed mesh cache. The cache is disabled if
+     *     empty.
      */
     UrdfObjectModelLoader(
-        const std::shared_ptr<KinematicsFromURDF>& urdf_kinematics);
+        const std::shared_ptr<KinematicsFromURDF>& urdf_kinematics,
+        const std::string& mesh_cache_directory =
+            MeshCache::default_directory());
 
     /**
-     * \brief Loads the mesh from urdf kinematics
+     * \brief Loads the mesh from urdf kinematics. Meshes are read from the
+     *        mesh cache if possible and imported and cached otherwise.
      */
     void load(
         std::vector<std::vector<Eigen::Vector3d>>& vertices,
         std::vector<std::vector<std::vector<int>>>& triangle_indices) const;
 
+    /**
+     * \brief Loads the meshes in the flat float vertex and uint32 index
+     *        layout. The buffers are filled straight from the mesh cache or
+     *        the importer, load() converts them into the dbot layout.
+     */
+    void load(std::vector<PartMeshBuffers>& meshes) const;
+
+    /**
+     * \brief Sets the maximum number of triangles of each link mesh. Larger
+     *        meshes are decimated after loading. A budget of 0, the default,
+     *        keeps the full resolution.
+     */
+    void triangle_budget(std::size_t budget);
+
+    /**
+     * \brief Overrides the triangle budget of a single link
+     */
+    void triangle_budget(const std::string& link_name, std::size_t budget);
+
 private:
     std::shared_ptr<KinematicsFromURDF> urdf_kinematics_;
+    std::shared_ptr<MeshCache> mesh_cache_;
+    std::size_t triangle_budget_;
+    std::unordered_map<std::string, std::size_t> link_triangle_budgets_;
+};
+
+/**
+ * \brief Provides already loaded flat mesh buffers to dbot::ObjectModel, such
+ *        that the model and a TileDepthRenderer can be built from a single
+ *        UrdfObjectModelLoader::load() of the meshes
+ */
+class PartMeshBuffersLoader : public dbot::ObjectModelLoader
+{
+public:
+    explicit PartMeshBuffersLoader(
+        const std::shared_ptr<const std::vector<PartMeshBuffers>>& meshes);
+
+    /**
+     * \brief Converts the buffers into the dbot layout
+     */
+    void load(
+        std::vector<std::vector<Eigen::Vector3d>>& vertices,
+        std::vector<std::vector<std::vector<int>>>& triangle_indices) const;
+
+private:
+    std::shared_ptr<const std::vector<PartMeshBuffers>> meshes_;
 };
 }
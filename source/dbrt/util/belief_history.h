@@ -0,0 +1,213 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file belief_history.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+namespace dbrt
+{
+/**
+ * \brief Sliding window of time stamped joint observations together with the
+ *        compact belief snapshot obtained after tracking each of them.
+ *
+ * All records live in one arena which is allocated once at construction.
+ * Every record consists of a time stamp, an observation of obsrv_dim() values
+ * and a belief snapshot of snapshot_dim() values. Once the history is full,
+ * appending a record overwrites the oldest one.
+ *
+ * Records are indexed from the oldest (0) to the newest (size() - 1) and have
+ * to be appended in chronological order. The first snapshot_count() records
+ * carry a valid snapshot, the remaining ones still have to be tracked.
+ */
+class BeliefHistory
+{
+public:
+    typedef Eigen::Map<Eigen::VectorXd> VectorMap;
+    typedef Eigen::Map<const Eigen::VectorXd> ConstVectorMap;
+
+    BeliefHistory(int obsrv_dim, int snapshot_dim, std::size_t capacity)
+        : obsrv_dim_(obsrv_dim),
+          snapshot_dim_(snapshot_dim),
+          stride_(obsrv_dim + snapshot_dim),
+          capacity_(capacity),
+          timestamps_(capacity),
+          records_(capacity * stride_),
+          first_(0),
+          size_(0),
+          snapshot_count_(0)
+    {
+    }
+
+    /**
+     * \brief Appends an observation without a snapshot. Returns false if the
+     *        history was full and the oldest record has been overwritten.
+     */
+    bool push_back(double timestamp,
+                   const Eigen::Ref<const Eigen::VectorXd>& obsrv)
+    {
+        bool evicted = false;
+        if (size_ == capacity_)
+        {
+            pop_front();
+            evicted = true;
+        }
+
+        const std::size_t slot = (first_ + size_) % capacity_;
+        timestamps_[slot] = timestamp;
+        VectorMap(&records_[slot * stride_], obsrv_dim_) = obsrv;
+        ++size_;
+
+        return !evicted;
+    }
+
+    /**
+     * \brief Returns the index of the oldest record with a valid snapshot
+     *        which is strictly newer than the given time stamp or -1 if there
+     *        is no such record.
+     */
+    int find(double timestamp) const
+    {
+        std::size_t index = bound(timestamp, snapshot_count_, true);
+        if (index == snapshot_count_) return -1;
+
+        return int(index);
+    }
+
+    /**
+     * \brief Removes all records older than the given time stamp and returns
+     *        the number of removed records.
+     */
+    std::size_t evict_older_than(double timestamp)
+    {
+        std::size_t count = bound(timestamp, size_, false);
+        pop_front(count);
+
+        return count;
+    }
+
+    /**
+     * \brief Removes the given number of oldest records
+     */
+    void pop_front(std::size_t count = 1)
+    {
+        count = std::min(count, size_);
+        first_ = (first_ + count) % capacity_;
+        size_ -= count;
+        snapshot_count_ -= std::min(count, snapshot_count_);
+    }
+
+    double timestamp(std::size_t index) const
+    {
+        return timestamps_[slot(index)];
+    }
+
+    ConstVectorMap obsrv(std::size_t index) const
+    {
+        return ConstVectorMap(&records_[slot(index) * stride_], obsrv_dim_);
+    }
+
+    VectorMap snapshot(std::size_t index)
+    {
+        return VectorMap(&records_[slot(index) * stride_ + obsrv_dim_],
+                         snapshot_dim_);
+    }
+
+    ConstVectorMap snapshot(std::size_t index) const
+    {
+        return ConstVectorMap(&records_[slot(index) * stride_ + obsrv_dim_],
+                              snapshot_dim_);
+    }
+
+    /**
+     * \brief Number of oldest records carrying a valid snapshot
+     */
+    std::size_t snapshot_count() const { return snapshot_count_; }
+
+    /**
+     * \brief Marks the snapshot of the record at index snapshot_count() as
+     *        valid
+     */
+    void commit_snapshot() { ++snapshot_count_; }
+
+    /**
+     * \brief Marks all snapshots as invalid such that all records have to be
+     *        tracked again
+     */
+    void invalidate_snapshots() { snapshot_count_ = 0; }
+
+    std::size_t size() const { return size_; }
+    std::size_t capacity() const { return capacity_; }
+    bool empty() const { return size_ == 0; }
+    int obsrv_dim() const { return obsrv_dim_; }
+    int snapshot_dim() const { return snapshot_dim_; }
+
+    void clear()
+    {
+        first_ = 0;
+        size_ = 0;
+        snapshot_count_ = 0;
+    }
+
+private:
+    std::size_t slot(std::size_t index) const
+    {
+        return (first_ + index) % capacity_;
+    }
+
+    /**
+     * \brief Binary search within the first count records. Returns the index
+     *        of the first record newer than (upper) or not older than (lower)
+     *        the given time stamp.
+     */
+    std::size_t bound(double timestamp, std::size_t count, bool upper) const
+    {
+        std::size_t low = 0;
+        std::size_t high = count;
+        while (low < high)
+        {
+            const std::size_t middle = low + (high - low) / 2;
+            const double t = timestamps_[slot(middle)];
+            if (upper ? t <= timestamp : t < timestamp)
+            {
+                low = middle + 1;
+            }
+            else
+            {
+                high = middle;
+            }
+        }
+
+        return low;
+    }
+
+private:
+    const int obsrv_dim_;
+    const int snapshot_dim_;
+    const std::size_t stride_;
+    const std::size_t capacity_;
+    std::vector<double> timestamps_;
+    std::vector<double> records_;
+    std::size_t first_;
+    std::size_t size_;
+    std::size_t snapshot_count_;
+};
+}
@@ -0,0 +1,85 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file frustum_culler.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <dbrt/kinematics_from_urdf.h>
+
+namespace dbrt
+{
+/**
+ * \brief Tests bounding spheres of links against the view frustum of a
+ *        pinhole camera
+ */
+class FrustumCuller
+{
+public:
+    typedef KinematicsFromURDF::LinkPose LinkPose;
+
+    /**
+     * \param camera_matrix
+     *     Intrinsics at the given resolution, e.g.
+     *     dbot::CameraData::camera_matrix()
+     * \param near_plane
+     *     Minimum depth of visible points
+     */
+    FrustumCuller(const Eigen::Matrix3d& camera_matrix,
+                  int n_rows,
+                  int n_cols,
+                  float near_plane = 1e-3f)
+        : near_plane_(near_plane)
+    {
+        const float fx = camera_matrix(0, 0), fy = camera_matrix(1, 1);
+        const float cx = camera_matrix(0, 2), cy = camera_matrix(1, 2);
+
+        // the image covers the pixel centers 0 ... n - 1 plus half a pixel.
+        // A point is inside a side plane if normal.dot(point) >= 0.
+        planes_.col(0) = Eigen::Vector3f(fx, 0, cx + 0.5f);
+        planes_.col(1) = Eigen::Vector3f(-fx, 0, n_cols - 0.5f - cx);
+        planes_.col(2) = Eigen::Vector3f(0, fy, cy + 0.5f);
+        planes_.col(3) = Eigen::Vector3f(0, -fy, n_rows - 0.5f - cy);
+        planes_.colwise().normalize();
+    }
+
+    /**
+     * \brief Returns false if the sphere given in the link frame lies
+     *        completely outside of the frustum for the given camera relative
+     *        link pose
+     */
+    bool visible(const LinkPose& pose,
+                 const Eigen::Vector3f& center,
+                 float radius) const
+    {
+        const float* m = pose.affine;
+        const Eigen::Vector3f c(
+            m[0] * center(0) + m[1] * center(1) + m[2] * center(2) + m[3],
+            m[4] * center(0) + m[5] * center(1) + m[6] * center(2) + m[7],
+            m[8] * center(0) + m[9] * center(1) + m[10] * center(2) + m[11]);
+
+        if (c(2) + radius < near_plane_) return false;
+
+        return ((planes_.transpose() * c).array() >= -radius).all();
+    }
+
+private:
+    float near_plane_;
+    // normals of the left, right, top and bottom planes
+    Eigen::Matrix<float, 3, 4, Eigen::DontAlign> planes_;
+};
+}
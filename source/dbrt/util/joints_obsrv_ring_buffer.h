@@ -0,0 +1,177 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file joints_obsrv_ring_buffer.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+namespace dbrt
+{
+/**
+ * \brief Bounded single-producer/single-consumer ring buffer of time stamped
+ *        joint observations.
+ *
+ * All observations have the same dimension (the joint count) and are stored
+ * back to back in one preallocated block. push() and pop() neither allocate
+ * nor lock. push() may only be called from one producer thread (the joint
+ * state callback) and pop() from one consumer thread (the rotary tracker).
+ *
+ * If the buffer is full, the newest observation is rejected and counted as an
+ * overflow.
+ */
+class JointsObsrvRingBuffer
+{
+public:
+    /**
+     * \brief Creates the buffer
+     *
+     * \param joint_count
+     *     Dimension of every observation
+     * \param capacity
+     *     Minimum number of observations the buffer can hold. This is rounded
+     *     up to the next power of two.
+     */
+    JointsObsrvRingBuffer(int joint_count, std::size_t capacity)
+        : joint_count_(joint_count),
+          capacity_(next_power_of_two(capacity)),
+          mask_(capacity_ - 1),
+          timestamps_(capacity_),
+          obsrvs_(capacity_ * joint_count),
+          head_(0),
+          tail_(0),
+          overflow_count_(0),
+          dropped_count_(0)
+    {
+    }
+
+    /**
+     * \brief Appends an observation. Returns false if it had to be dropped,
+     *        either because the buffer is full or because the observation
+     *        does not have joint_count() entries.
+     *
+     * Producer thread only.
+     */
+    bool push(double timestamp, const Eigen::Ref<const Eigen::VectorXd>& obsrv)
+    {
+        if (obsrv.size() != joint_count_)
+        {
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == capacity_)
+        {
+            overflow_count_.fetch_add(1, std::memory_order_relaxed);
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        const std::size_t slot = head & mask_;
+        timestamps_[slot] = timestamp;
+        Eigen::Map<Eigen::VectorXd>(&obsrvs_[slot * joint_count_],
+                                    joint_count_) = obsrv;
+
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Removes the oldest observation and writes it into the given
+     *        arguments. Returns false if the buffer is empty.
+     *
+     * The observation vector is only resized if it does not have
+     * joint_count() entries already. Consumer thread only.
+     */
+    bool pop(double& timestamp, Eigen::VectorXd& obsrv)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+
+        const std::size_t slot = tail & mask_;
+        timestamp = timestamps_[slot];
+        obsrv = Eigen::Map<const Eigen::VectorXd>(&obsrvs_[slot * joint_count_],
+                                                  joint_count_);
+
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Number of observations currently buffered. Exact only when
+     *        called from the producer or the consumer thread.
+     */
+    std::size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) -
+               tail_.load(std::memory_order_acquire);
+    }
+
+    bool empty() const { return size() == 0; }
+    std::size_t capacity() const { return capacity_; }
+    int joint_count() const { return joint_count_; }
+
+    /**
+     * \brief Number of observations rejected because the buffer was full
+     */
+    std::size_t overflow_count() const
+    {
+        return overflow_count_.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Total number of rejected observations, including overflows and
+     *        observations of the wrong dimension
+     */
+    std::size_t dropped_count() const
+    {
+        return dropped_count_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static std::size_t next_power_of_two(std::size_t n)
+    {
+        std::size_t power = 1;
+        while (power < n) power <<= 1;
+        return power;
+    }
+
+private:
+    const int joint_count_;
+    const std::size_t capacity_;
+    const std::size_t mask_;
+    std::vector<double> timestamps_;
+    std::vector<double> obsrvs_;
+
+    // producer and consumer indices live on separate cache lines to avoid
+    // false sharing between the two threads
+    std::atomic<std::size_t> head_;
+    char head_padding_[64];
+    std::atomic<std::size_t> tail_;
+    char tail_padding_[64];
+
+    std::atomic<std::size_t> overflow_count_;
+    std::atomic<std::size_t> dropped_count_;
+};
+}
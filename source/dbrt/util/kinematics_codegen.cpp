@@ -0,0 +1,374 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file kinematics_codegen.cpp
+ * \date October 2026
+ *
+ * Build time generator of the forward kinematics of a fixed robot
+ * description. The generated header dbrt/generated_kinematics.h contains a
+ * single straight line function computing all segment frames of the flat
+ * kinematic tree of KinematicsFromURDF:
+ *
+ *  - segments which do not depend on any joint are folded into constants,
+ *  - fixed transforms preceding or following a joint are merged into the
+ *    constants of that joint,
+ *  - rotations about and translations along coordinate axes are expanded
+ *    into their few non-trivial terms.
+ *
+ * Usage: kinematics_codegen <urdf file> <camera frame id> <output header>
+ */
+
+#include <cmath>
+#include <dbrt/kinematics_from_urdf.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+typedef KinematicsFromURDF::SegmentModel SegmentModel;
+
+static bool is_identity(const KDL::Frame& frame)
+{
+    static const double identity[9] = {1, 0, 0, 0, 1, 0, 0, 0, 1};
+    for (int i = 0; i < 9; ++i)
+    {
+        if (frame.M.data[i] != identity[i]) return false;
+    }
+
+    return frame.p.x() == 0 && frame.p.y() == 0 && frame.p.z() == 0;
+}
+
+/**
+ * \brief Returns the index of the coordinate axis (0, 1, 2) the given axis
+ *        points along and its sign or -1 for a general axis
+ */
+static int coordinate_axis(const KDL::Vector& axis, double& sign)
+{
+    const double eps = 1e-12;
+    for (int i = 0; i < 3; ++i)
+    {
+        if (std::fabs(std::fabs(axis(i)) - 1.0) < eps &&
+            std::fabs(axis((i + 1) % 3)) < eps &&
+            std::fabs(axis((i + 2) % 3)) < eps)
+        {
+            sign = axis(i) > 0 ? 1.0 : -1.0;
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+static std::string literal(double value)
+{
+    std::ostringstream stream;
+    stream.precision(17);
+    stream << value;
+
+    std::string text = stream.str();
+    if (text.find_first_of(".en") == std::string::npos) text += ".0";
+
+    return text;
+}
+
+static std::string frame_literal(const KDL::Frame& frame)
+{
+    std::string text = "{";
+    for (int i = 0; i < 9; ++i)
+    {
+        text += literal(frame.M.data[i]) + ", ";
+    }
+    text += literal(frame.p.x()) + ", " + literal(frame.p.y()) + ", " +
+            literal(frame.p.z()) + "}";
+
+    return text;
+}
+
+static std::string frame_pointer(int segment)
+{
+    return "f + " + std::to_string(segment * 12);
+}
+
+/**
+ * \brief Emits m = a * motion(t) where a and m are 3x4 frames
+ */
+static void emit_motion(const SegmentModel& model,
+                        const std::string& t,
+                        std::ostream& out)
+{
+    const std::string indent = "        ";
+    double sign;
+    const int axis = coordinate_axis(model.axis, sign);
+    const std::string signed_t = sign < 0 ? "-(" + t + ")" : t;
+
+    if (model.type == SegmentModel::Translational)
+    {
+        out << indent << "const double d = " << (axis >= 0 ? signed_t : t)
+            << ";\n";
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                out << indent << "m[" << r * 3 + c << "] = a[" << r * 3 + c
+                    << "];\n";
+            }
+
+            out << indent << "m[" << 9 + r << "] = a[" << 9 + r << "] + ";
+            if (axis >= 0)
+            {
+                out << "a[" << r * 3 + axis << "] * d;\n";
+            }
+            else
+            {
+                out << "(a[" << r * 3 << "] * " << literal(model.axis.x())
+                    << " + a[" << r * 3 + 1 << "] * "
+                    << literal(model.axis.y()) << " + a[" << r * 3 + 2
+                    << "] * " << literal(model.axis.z()) << ") * d;\n";
+            }
+        }
+        return;
+    }
+
+    out << indent << "const double c = std::cos("
+        << (axis >= 0 ? signed_t : t) << ");\n";
+    out << indent << "const double s = std::sin("
+        << (axis >= 0 ? signed_t : t) << ");\n";
+
+    for (int r = 9; r < 12; ++r)
+    {
+        out << indent << "m[" << r << "] = a[" << r << "];\n";
+    }
+
+    if (axis < 0)
+    {
+        // Rodrigues' formula R = c I + (1 - c) k k^T + s [k]x
+        const KDL::Vector& k = model.axis;
+        out << indent << "const double v = 1.0 - c;\n";
+        out << indent << "const double rot[9] = {\n";
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int j = 0; j < 3; ++j)
+            {
+                out << indent << "    ";
+                if (i == j) out << "c + ";
+                out << "v * " << literal(k(i) * k(j));
+                if (i != j)
+                {
+                    // [k]x has -k(2) at (0, 1), k(1) at (0, 2), ...
+                    const int l = 3 - i - j;
+                    const double cross_sign = (j - i + 3) % 3 == 1 ? -1 : 1;
+                    out << " + s * " << literal(cross_sign * k(l));
+                }
+                out << ",\n";
+            }
+        }
+        out << indent << "};\n";
+        for (int r = 0; r < 3; ++r)
+        {
+            for (int c = 0; c < 3; ++c)
+            {
+                out << indent << "m[" << r * 3 + c << "] = a[" << r * 3
+                    << "] * rot[" << c << "] + a[" << r * 3 + 1 << "] * rot["
+                    << 3 + c << "] + a[" << r * 3 + 2 << "] * rot[" << 6 + c
+                    << "];\n";
+            }
+        }
+        return;
+    }
+
+    // only the two columns orthogonal to the axis change
+    const int u = (axis + 1) % 3;
+    const int w = (axis + 2) % 3;
+    for (int r = 0; r < 3; ++r)
+    {
+        const std::string au = "a[" + std::to_string(r * 3 + u) + "]";
+        const std::string aw = "a[" + std::to_string(r * 3 + w) + "]";
+
+        out << indent << "m[" << r * 3 + axis << "] = a[" << r * 3 + axis
+            << "];\n";
+        out << indent << "m[" << r * 3 + u << "] = c * " << au << " + s * "
+            << aw << ";\n";
+        out << indent << "m[" << r * 3 + w << "] = c * " << aw << " - s * "
+            << au << ";\n";
+    }
+}
+
+static void generate(const KinematicsFromURDF& kinematics, std::ostream& out)
+{
+    const auto& models = kinematics.segment_models();
+    const auto& parents = kinematics.segment_parents();
+    const auto& joint_indices = kinematics.segment_joint_indices();
+    const int count = kinematics.num_segments();
+
+    out << "// Generated by kinematics_codegen. Do not edit.\n\n"
+        << "#pragma once\n\n"
+        << "#include <cmath>\n"
+        << "#include <cstdint>\n\n"
+        << "namespace dbrt\n{\n"
+        << "namespace generated_kinematics\n{\n"
+        << "const std::uint64_t fingerprint = "
+        << kinematics.model_fingerprint() << "ull;\n"
+        << "const int segment_count = " << count << ";\n\n"
+        << "// out = a * b of two frames in row-major rotation + translation "
+           "layout\n"
+        << "inline void compose(const double* a, const double* b, double* "
+           "out)\n{\n"
+        << "    for (int r = 0; r < 3; ++r)\n    {\n"
+        << "        const double a0 = a[r * 3], a1 = a[r * 3 + 1], "
+           "a2 = a[r * 3 + 2];\n"
+        << "        out[r * 3] = a0 * b[0] + a1 * b[3] + a2 * b[6];\n"
+        << "        out[r * 3 + 1] = a0 * b[1] + a1 * b[4] + a2 * b[7];\n"
+        << "        out[r * 3 + 2] = a0 * b[2] + a1 * b[5] + a2 * b[8];\n"
+        << "        out[9 + r] = a0 * b[9] + a1 * b[10] + a2 * b[11] + "
+           "a[9 + r];\n"
+        << "    }\n}\n\n"
+        << "/**\n"
+        << " * \\brief Computes the frames of all segment tips relative to the "
+           "root.\n"
+        << " *\n"
+        << " * \\param q       joint state\n"
+        << " * \\param f       segment_count frames of 12 values each\n"
+        << " */\n"
+        << "inline void compute_segment_frames(const double* q, double* f)\n"
+        << "{\n";
+
+    // frames of segments which do not depend on any joint
+    std::vector<bool> constant(count, false);
+    std::vector<KDL::Frame> constant_frames(count);
+
+    for (int i = 0; i < count; ++i)
+    {
+        const SegmentModel& model = models[i];
+        const int parent = parents[i];
+        const bool parent_constant = parent < 0 || constant[parent];
+        const KDL::Frame parent_frame =
+            parent < 0 ? KDL::Frame::Identity() : constant_frames[parent];
+
+        out << "    // segment " << i << "\n";
+
+        if (model.type == SegmentModel::Fixed && parent_constant)
+        {
+            constant[i] = true;
+            constant_frames[i] = parent_frame * model.origin * model.tip;
+
+            out << "    {\n"
+                << "        static constexpr double k[12] = "
+                << frame_literal(constant_frames[i]) << ";\n"
+                << "        for (int j = 0; j < 12; ++j) f[" << i * 12
+                << " + j] = k[j];\n"
+                << "    }\n";
+            continue;
+        }
+
+        if (model.type == SegmentModel::Fixed)
+        {
+            out << "    {\n"
+                << "        static constexpr double k[12] = "
+                << frame_literal(model.origin * model.tip) << ";\n"
+                << "        compose(" << frame_pointer(parent) << ", k, "
+                << frame_pointer(i) << ");\n"
+                << "    }\n";
+            continue;
+        }
+
+        out << "    {\n";
+
+        // a = parent * origin
+        if (parent_constant)
+        {
+            out << "        static constexpr double a[12] = "
+                << frame_literal(parent_frame * model.origin) << ";\n";
+        }
+        else if (is_identity(model.origin))
+        {
+            out << "        const double* a = " << frame_pointer(parent)
+                << ";\n";
+        }
+        else
+        {
+            out << "        static constexpr double origin[12] = "
+                << frame_literal(model.origin) << ";\n"
+                << "        double a[12];\n"
+                << "        compose(" << frame_pointer(parent)
+                << ", origin, a);\n";
+        }
+
+        // m = a * motion, f = m * tip
+        const bool tip_identity = is_identity(model.tip);
+        if (tip_identity)
+        {
+            out << "        double* m = " << frame_pointer(i) << ";\n";
+        }
+        else
+        {
+            out << "        static constexpr double tip[12] = "
+                << frame_literal(model.tip) << ";\n"
+                << "        double m[12];\n";
+        }
+
+        std::string t = "q[" + std::to_string(joint_indices[i]) + "]";
+        if (model.scale != 1.0) t = literal(model.scale) + " * " + t;
+        emit_motion(model, t, out);
+
+        if (!tip_identity)
+        {
+            out << "        compose(m, tip, " << frame_pointer(i) << ");\n";
+        }
+
+        out << "    }\n";
+    }
+
+    out << "}\n}\n}\n";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "Usage: " << argv[0]
+                  << " <urdf file> <camera frame id> <output header>"
+                  << std::endl;
+        return 1;
+    }
+
+    std::ifstream urdf_file(argv[1]);
+    if (!urdf_file)
+    {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+    std::stringstream robot_description;
+    robot_description << urdf_file.rdbuf();
+
+    // meshes and rendering roots do not affect the kinematics
+    KinematicsFromURDF kinematics(
+        robot_description.str(), "", "", "", argv[2], false);
+
+    if (kinematics.num_segments() == 0)
+    {
+        std::cerr << "Robot description has no segments" << std::endl;
+        return 1;
+    }
+
+    std::ofstream header(argv[3]);
+    generate(kinematics, header);
+    if (!header)
+    {
+        std::cerr << "Cannot write " << argv[3] << std::endl;
+        return 1;
+    }
+
+    return 0;
+}
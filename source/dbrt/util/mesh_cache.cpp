@@ -0,0 +1,270 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file mesh_cache.cpp
+ * \date October 2026
+ */
+
+#include <boost/filesystem.hpp>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dbrt/util/mesh_cache.h>
+#include <fcntl.h>
+#include <fstream>
+#include <ros/ros.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace dbrt
+{
+namespace
+{
+const char entry_magic[8] = {'D', 'B', 'R', 'T', 'M', 'S', 'H', '2'};
+
+/**
+ * \brief Layout of a cache entry: the header, the mesh path padded to 8
+ *        bytes, the vertices as 3 floats each and the triangles as 3 uint32
+ *        indices each, i.e. the buffers of PartMeshBuffers. Entries are only
+ *        valid on the machine which wrote them.
+ */
+struct EntryHeader
+{
+    char magic[8];
+    std::uint64_t path_size;
+    std::int64_t mtime_ns;
+    std::uint64_t file_size;
+    // row-major rotation followed by the translation
+    double origin[12];
+    std::uint64_t vertex_count;
+    std::uint64_t triangle_count;
+};
+
+std::size_t padded(std::size_t size)
+{
+    return (size + 7) & ~std::size_t(7);
+}
+
+void origin_values(const Eigen::Affine3d& origin, double values[12])
+{
+    for (int r = 0; r < 3; ++r)
+    {
+        for (int c = 0; c < 3; ++c)
+        {
+            values[r * 3 + c] = origin.linear()(r, c);
+        }
+        values[9 + r] = origin.translation()(r);
+    }
+}
+
+// fills the key fields of the header from the mesh file
+bool stamp_header(const std::string& mesh_path,
+                  const Eigen::Affine3d& origin,
+                  EntryHeader& header)
+{
+    struct stat mesh_stat;
+    if (stat(mesh_path.c_str(), &mesh_stat) != 0) return false;
+
+    std::memcpy(header.magic, entry_magic, sizeof(entry_magic));
+    header.path_size = mesh_path.size();
+    header.mtime_ns = std::int64_t(mesh_stat.st_mtim.tv_sec) * 1000000000 +
+                      mesh_stat.st_mtim.tv_nsec;
+    header.file_size = mesh_stat.st_size;
+    origin_values(origin, header.origin);
+
+    return true;
+}
+
+/**
+ * \brief Read-only memory mapping of a whole file
+ */
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path) : data_(nullptr), size_(0)
+    {
+        int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+
+        struct stat file_stat;
+        if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0)
+        {
+            void* data = mmap(
+                nullptr, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                data_ = static_cast<const char*>(data);
+                size_ = file_stat.st_size;
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile()
+    {
+        if (data_) munmap(const_cast<char*>(data_), size_);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const char* data() const { return data_; }
+    std::size_t size() const { return size_; }
+
+private:
+    const char* data_;
+    std::size_t size_;
+};
+}
+
+MeshCache::MeshCache(const std::string& directory) : directory_(directory)
+{
+}
+
+std::string MeshCache::default_directory()
+{
+    const char* ros_home = std::getenv("ROS_HOME");
+    if (ros_home) return std::string(ros_home) + "/dbrt_mesh_cache";
+
+    const char* home = std::getenv("HOME");
+    return std::string(home ? home : ".") + "/.ros/dbrt_mesh_cache";
+}
+
+std::string MeshCache::entry_path(const std::string& mesh_path,
+                                  const Eigen::Affine3d& origin) const
+{
+    double values[12];
+    origin_values(origin, values);
+
+    // FNV-1a over the path and the origin
+    std::uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](const void* data, std::size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            hash = (hash ^ bytes[i]) * 1099511628211ull;
+        }
+    };
+    add(mesh_path.data(), mesh_path.size());
+    add(values, sizeof(values));
+
+    char name[32];
+    std::snprintf(name,
+                  sizeof(name),
+                  "%016llx.mesh",
+                  static_cast<unsigned long long>(hash));
+
+    return directory_ + "/" + name;
+}
+
+bool MeshCache::read(const std::string& mesh_path,
+                     const Eigen::Affine3d& origin,
+                     PartMeshBuffers& mesh) const
+{
+    EntryHeader key;
+    if (!stamp_header(mesh_path, origin, key)) return false;
+
+    MappedFile file(entry_path(mesh_path, origin));
+    if (!file.data() || file.size() < sizeof(EntryHeader)) return false;
+
+    EntryHeader header;
+    std::memcpy(&header, file.data(), sizeof(EntryHeader));
+    if (std::memcmp(header.magic, key.magic, sizeof(key.magic)) != 0 ||
+        header.path_size != key.path_size ||
+        header.mtime_ns != key.mtime_ns ||
+        header.file_size != key.file_size ||
+        std::memcmp(header.origin, key.origin, sizeof(key.origin)) != 0)
+    {
+        return false;
+    }
+
+    const std::size_t path_offset = sizeof(EntryHeader);
+    const std::size_t vertex_offset = path_offset + padded(header.path_size);
+    const std::size_t index_offset =
+        vertex_offset + header.vertex_count * 3 * sizeof(float);
+    const std::size_t end =
+        index_offset + header.triangle_count * 3 * sizeof(std::uint32_t);
+    if (end != file.size() ||
+        mesh_path.compare(
+            0, std::string::npos, file.data() + path_offset, header.path_size))
+    {
+        return false;
+    }
+
+    mesh.vertices.resize(3 * header.vertex_count);
+    std::memcpy(mesh.vertices.data(),
+                file.data() + vertex_offset,
+                mesh.vertices.size() * sizeof(float));
+    mesh.indices.resize(3 * header.triangle_count);
+    std::memcpy(mesh.indices.data(),
+                file.data() + index_offset,
+                mesh.indices.size() * sizeof(std::uint32_t));
+
+    return true;
+}
+
+void MeshCache::write(const std::string& mesh_path,
+                      const Eigen::Affine3d& origin,
+                      const PartMeshBuffers& mesh) const
+{
+    EntryHeader header;
+    if (!stamp_header(mesh_path, origin, header)) return;
+    header.vertex_count = mesh.vertex_count();
+    header.triangle_count = mesh.triangle_count();
+
+    boost::system::error_code error;
+    boost::filesystem::create_directories(directory_, error);
+    if (error)
+    {
+        ROS_WARN("Cannot create mesh cache directory %s: %s",
+                 directory_.c_str(),
+                 error.message().c_str());
+        return;
+    }
+
+    // write to a unique file first such that concurrent readers and writers
+    // never see a partial entry
+    const std::string path = entry_path(mesh_path, origin);
+    const std::string temporary_path =
+        path + boost::filesystem::unique_path(".%%%%-%%%%-%%%%").string();
+
+    {
+        const char padding[8] = {};
+        std::ofstream file(temporary_path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(mesh_path.data(), mesh_path.size());
+        file.write(padding, padded(mesh_path.size()) - mesh_path.size());
+        file.write(reinterpret_cast<const char*>(mesh.vertices.data()),
+                   mesh.vertices.size() * sizeof(float));
+        file.write(reinterpret_cast<const char*>(mesh.indices.data()),
+                   mesh.indices.size() * sizeof(std::uint32_t));
+        file.close();
+
+        if (!file)
+        {
+            ROS_WARN("Cannot write mesh cache entry %s", path.c_str());
+            std::remove(temporary_path.c_str());
+            return;
+        }
+    }
+
+    if (std::rename(temporary_path.c_str(), path.c_str()) != 0)
+    {
+        ROS_WARN("Cannot write mesh cache entry %s", path.c_str());
+        std::remove(temporary_path.c_str());
+    }
+}
+}
@@ -0,0 +1,73 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file mesh_cache.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <Eigen/Dense>
+#include <dbrt/part_mesh_model.h>
+#include <string>
+
+namespace dbrt
+{
+/**
+ * \brief On-disk cache of link meshes which are already transformed by the
+ *        origin of the link geometry.
+ *
+ * An entry is keyed by the mesh file path, the modification time and size
+ * of the mesh file and the origin transform. Entries are memory-mapped and
+ * their flat buffers are copied out without any parsing. Entries which no
+ * longer match their mesh file are misses and are replaced by the next
+ * write().
+ */
+class MeshCache
+{
+public:
+    /**
+     * \param directory
+     *     Directory of the cache files. It is created on the first write.
+     */
+    explicit MeshCache(const std::string& directory);
+
+    /**
+     * \brief $ROS_HOME/dbrt_mesh_cache or ~/.ros/dbrt_mesh_cache
+     */
+    static std::string default_directory();
+
+    /**
+     * \brief Reads the mesh of the given file and origin. Returns false on a
+     *        miss.
+     */
+    bool read(const std::string& mesh_path,
+              const Eigen::Affine3d& origin,
+              PartMeshBuffers& mesh) const;
+
+    /**
+     * \brief Stores the transformed mesh of the given file and origin. Write
+     *        failures are reported and otherwise ignored.
+     */
+    void write(const std::string& mesh_path,
+               const Eigen::Affine3d& origin,
+               const PartMeshBuffers& mesh) const;
+
+private:
+    std::string entry_path(const std::string& mesh_path,
+                           const Eigen::Affine3d& origin) const;
+
+    std::string directory_;
+};
+}
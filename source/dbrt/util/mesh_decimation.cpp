@@ -0,0 +1,157 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file mesh_decimation.cpp
+ * \date October 2026
+ */
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <dbrt/util/mesh_decimation.h>
+#include <limits>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace dbrt
+{
+namespace
+{
+struct TriangleHash
+{
+    std::size_t operator()(const std::array<std::uint32_t, 3>& t) const
+    {
+        std::uint64_t hash = 14695981039346656037ull;
+        for (auto index : t) hash = (hash ^ index) * 1099511628211ull;
+        return hash;
+    }
+};
+
+/**
+ * \brief Clusters the vertices on a grid of the given number of cells along
+ *        the longest side of the bounding box
+ */
+PartMeshBuffers cluster(const PartMeshBuffers& mesh,
+                        const Eigen::Vector3f& min,
+                        float extent,
+                        int resolution)
+{
+    const std::size_t vertex_count = mesh.vertex_count();
+    const float cell_size = extent / resolution;
+    const std::uint64_t cells = resolution + 1;
+
+    // cluster index of every vertex and the vertex sums of the clusters
+    std::unordered_map<std::uint64_t, std::uint32_t> cell_clusters;
+    std::vector<std::uint32_t> vertex_clusters(vertex_count);
+    std::vector<Eigen::Vector3f> sums;
+    std::vector<int> counts;
+    for (std::size_t v = 0; v < vertex_count; ++v)
+    {
+        const Eigen::Map<const Eigen::Vector3f> vertex(&mesh.vertices[3 * v]);
+        const Eigen::Vector3f cell =
+            ((vertex - min) / cell_size).array().floor();
+        const std::uint64_t key =
+            (std::uint64_t(cell(0)) * cells + std::uint64_t(cell(1))) * cells +
+            std::uint64_t(cell(2));
+
+        auto entry = cell_clusters.emplace(key, sums.size());
+        if (entry.second)
+        {
+            sums.push_back(Eigen::Vector3f::Zero());
+            counts.push_back(0);
+        }
+        vertex_clusters[v] = entry.first->second;
+        sums[entry.first->second] += vertex;
+        counts[entry.first->second]++;
+    }
+
+    PartMeshBuffers result;
+    result.vertices.resize(3 * sums.size());
+    for (std::size_t c = 0; c < sums.size(); ++c)
+    {
+        Eigen::Map<Eigen::Vector3f>(&result.vertices[3 * c]) =
+            sums[c] / counts[c];
+    }
+
+    std::unordered_set<std::array<std::uint32_t, 3>, TriangleHash> triangles;
+    for (std::size_t t = 0; t < mesh.triangle_count(); ++t)
+    {
+        std::array<std::uint32_t, 3> triangle = {
+            {vertex_clusters[mesh.indices[3 * t]],
+             vertex_clusters[mesh.indices[3 * t + 1]],
+             vertex_clusters[mesh.indices[3 * t + 2]]}};
+        if (triangle[0] == triangle[1] || triangle[1] == triangle[2] ||
+            triangle[2] == triangle[0])
+        {
+            continue;
+        }
+
+        // rotate the smallest index to the front, which keeps the winding
+        std::rotate(triangle.begin(),
+                    std::min_element(triangle.begin(), triangle.end()),
+                    triangle.end());
+        if (triangles.insert(triangle).second)
+        {
+            result.indices.insert(
+                result.indices.end(), triangle.begin(), triangle.end());
+        }
+    }
+
+    return result;
+}
+}
+
+PartMeshBuffers decimate_mesh(const PartMeshBuffers& mesh,
+                              std::size_t triangle_budget)
+{
+    if (mesh.triangle_count() <= triangle_budget || mesh.vertex_count() == 0)
+    {
+        return mesh;
+    }
+
+    Eigen::Vector3f min = Eigen::Vector3f::Constant(
+        std::numeric_limits<float>::max());
+    Eigen::Vector3f max = -min;
+    for (std::size_t v = 0; v < mesh.vertex_count(); ++v)
+    {
+        const Eigen::Map<const Eigen::Vector3f> vertex(&mesh.vertices[3 * v]);
+        min = min.cwiseMin(vertex);
+        max = max.cwiseMax(vertex);
+    }
+    const float extent = std::max((max - min).maxCoeff(), 1e-6f);
+
+    // the triangle count roughly grows with the grid resolution, so search
+    // for a fine grid within the budget. The count is not monotonic, so the
+    // search may miss finer grids within the budget.
+    PartMeshBuffers best = cluster(mesh, min, extent, 1);
+    int low = 1;
+    int high = 1024;
+    while (low < high)
+    {
+        const int resolution = (low + high + 1) / 2;
+        PartMeshBuffers candidate = cluster(mesh, min, extent, resolution);
+        if (candidate.triangle_count() <= triangle_budget)
+        {
+            best = std::move(candidate);
+            low = resolution;
+        }
+        else
+        {
+            high = resolution - 1;
+        }
+    }
+
+    return best;
+}
+}
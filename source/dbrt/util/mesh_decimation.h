@@ -0,0 +1,43 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file mesh_decimation.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <dbrt/part_mesh_model.h>
+
+namespace dbrt
+{
+/**
+ * \brief Decimates the mesh to at most triangle_budget triangles by vertex
+ *        clustering.
+ *
+ * The vertices are snapped to a uniform grid over the bounding box of the
+ * mesh and the vertices of each cell are merged into their mean. Triangles
+ * which collapse or duplicate another one are dropped. A fine grid meeting
+ * the budget is searched, so the depth silhouette is kept as well as the
+ * budget allows. Meshes within the budget are returned unchanged.
+ *
+ * The triangle count does not strictly grow with the grid resolution, so the
+ * binary search over the resolution is a heuristic and may settle on a
+ * coarser grid than the finest one within the budget. If even a single
+ * cell per side exceeds the budget, that coarsest mesh is returned and
+ * exceeds the budget, so callers have to check the triangle count.
+ */
+PartMeshBuffers decimate_mesh(const PartMeshBuffers& mesh,
+                              std::size_t triangle_budget);
+}
@@ -41,7 +41,13 @@
 
 namespace dbrt
 {
-template <typename State>
+/**
+ * \brief Emulates the joint sensors and the depth camera of a robot.
+ *
+ * The Renderer provides Render(state, depth_image, bad_value) like
+ * dbot::RigidBodyRenderer or TileDepthRenderer.
+ */
+template <typename State, typename Renderer = dbot::RigidBodyRenderer>
 class RobotEmulator
 {
 public:
@@ -50,7 +56,7 @@ public:
      */
     RobotEmulator(const std::shared_ptr<dbot::ObjectModel>& object_model,
                   const std::shared_ptr<KinematicsFromURDF>& urdf_kinematics,
-                  const std::shared_ptr<dbot::RigidBodyRenderer>& renderer,
+                  const std::shared_ptr<Renderer>& renderer,
                   const std::shared_ptr<dbot::CameraData>& camera_data,
                   const std::shared_ptr<RobotAnimator>& robot_animator,
                   double joint_sensors_rate,
@@ -189,7 +195,7 @@ public:
                         })
                                 .detach();
             */
-            std::thread(std::bind(&RobotEmulator<State>::publisher_thread,
+            std::thread(std::bind(&RobotEmulator::publisher_thread,
                                   this,
                                   state,
                                   timestamp,
@@ -337,7 +343,7 @@ private:
     sensor_msgs::Image obsrv_image_;
     std::shared_ptr<dbot::ObjectModel> object_model_;
     std::shared_ptr<KinematicsFromURDF> urdf_kinematics_;
-    std::shared_ptr<dbot::RigidBodyRenderer> renderer_;
+    std::shared_ptr<Renderer> renderer_;
     std::shared_ptr<dbot::CameraData> camera_data_;
     std::shared_ptr<RobotAnimator> robot_animator_;
     std::shared_ptr<RobotPublisher<State>> robot_publisher_;
@@ -20,6 +20,7 @@
 #include <dbot/virtual_camera_data_provider.h>
 #include <dbot_ros/util/ros_interface.h>
 #include <dbrt/robot_state.h>
+#include <dbrt/tile_depth_renderer.h>
 #include <dbrt/urdf_object_loader.h>
 #include <dbrt/util/robot_emulator.h>
 #include <fl/util/profiling.hpp>
@@ -60,67 +61,16 @@ protected:
 };
 
 /**
- * \brief Node entry point
+ * \brief Runs the emulator with the given renderer until the node shuts down
  */
-int main(int argc, char** argv)
+template <typename State, typename Renderer>
+void run_emulator(ros::NodeHandle& nh,
+                  const std::string& prefix,
+                  const std::shared_ptr<Renderer>& renderer,
+                  const std::shared_ptr<dbot::ObjectModel>& object_model,
+                  const std::shared_ptr<KinematicsFromURDF>& urdf_kinematics,
+                  const std::shared_ptr<dbot::CameraData>& camera_data)
 {
-    ros::init(argc, argv, "robot_emulator");
-    ros::NodeHandle nh("~");
-
-    // parameter shorthand prefix
-    std::string prefix = "robot_emulator/";
-
-    /* ------------------------------ */
-    /* - Setup camera data          - */
-    /* ------------------------------ */
-    auto camera_downsampling_factor =
-        ri::read<double>(prefix + "camera_downsampling_factor", nh);
-    auto camera_frame_id = ri::read<std::string>("camera_frame_id", nh);
-
-    auto camera_data = std::make_shared<dbot::CameraData>(
-        std::make_shared<dbot::VirtualCameraDataProvider>(
-            camera_downsampling_factor, "/" + camera_frame_id));
-
-    /* ------------------------------ */
-    /* - Create the robot kinematics- */
-    /* - and robot mesh model       - */
-    /* ------------------------------ */
-
-    auto robot_description =
-        ri::read<std::string>("robot_description", ros::NodeHandle());
-    auto robot_description_package_path =
-        ri::read<std::string>("robot_description_package_path", nh);
-    auto rendering_root_left = ri::read<std::string>("rendering_root_left", nh);
-    auto rendering_root_right =
-        ri::read<std::string>("rendering_root_right", nh);
-
-    std::shared_ptr<KinematicsFromURDF> urdf_kinematics(
-        new KinematicsFromURDF(robot_description,
-                               robot_description_package_path,
-                               rendering_root_left,
-                               rendering_root_right,
-                               camera_frame_id));
-
-    auto object_model = std::make_shared<dbot::ObjectModel>(
-        std::make_shared<dbrt::UrdfObjectModelLoader>(urdf_kinematics), false);
-
-    /* ------------------------------ */
-    /* - Robot renderer             - */
-    /* ------------------------------ */
-    auto renderer = std::make_shared<dbot::RigidBodyRenderer>(
-        object_model->vertices(),
-        object_model->triangle_indices(),
-        camera_data->camera_matrix(),
-        camera_data->resolution().height,
-        camera_data->resolution().width);
-
-    /* ------------------------------ */
-    /* - Our state representation   - */
-    /* ------------------------------ */
-    dbrt::RobotState<>::kinematics_ = urdf_kinematics;
-    dbrt::RobotState<>::kinematics_mutex_ = std::make_shared<std::mutex>();
-    typedef dbrt::RobotState<> State;
-
     /* ------------------------------ */
     /* - Setup Simulation           - */
     /* ------------------------------ */
@@ -142,17 +92,18 @@ int main(int argc, char** argv)
     auto image_timestamp_delay =
         ri::read<double>(prefix + "image_timestamp_delay", nh);
 
-    dbrt::RobotEmulator<State> robot(object_model,
-                                     urdf_kinematics,
-                                     renderer,
-                                     camera_data,
-                                     robot_animator,
-                                     joint_rate,  // joint sensor rate
-                                     image_rate,  // visual sensor rate
-                                     dilation,
-                                     image_publishing_delay,
-                                     image_timestamp_delay,
-                                     state);
+    dbrt::RobotEmulator<State, Renderer> robot(
+        object_model,
+        urdf_kinematics,
+        renderer,
+        camera_data,
+        robot_animator,
+        joint_rate,  // joint sensor rate
+        image_rate,  // visual sensor rate
+        dilation,
+        image_publishing_delay,
+        image_timestamp_delay,
+        state);
 
     /* ------------------------------ */
     /* - Run emulator node          - */
@@ -189,6 +140,97 @@ int main(int argc, char** argv)
 
     ROS_INFO("Shutting down ...");
     robot.shutdown();
+}
+
+/**
+ * \brief Node entry point
+ */
+int main(int argc, char** argv)
+{
+    ros::init(argc, argv, "robot_emulator");
+    ros::NodeHandle nh("~");
+
+    // parameter shorthand prefix
+    std::string prefix = "robot_emulator/";
+
+    /* ------------------------------ */
+    /* - Setup camera data          - */
+    /* ------------------------------ */
+    auto camera_downsampling_factor =
+        ri::read<double>(prefix + "camera_downsampling_factor", nh);
+    auto camera_frame_id = ri::read<std::string>("camera_frame_id", nh);
+
+    auto camera_data = std::make_shared<dbot::CameraData>(
+        std::make_shared<dbot::VirtualCameraDataProvider>(
+            camera_downsampling_factor, "/" + camera_frame_id));
+
+    /* ------------------------------ */
+    /* - Create the robot kinematics- */
+    /* - and robot mesh model       - */
+    /* ------------------------------ */
+
+    auto robot_description =
+        ri::read<std::string>("robot_description", ros::NodeHandle());
+    auto robot_description_package_path =
+        ri::read<std::string>("robot_description_package_path", nh);
+    auto rendering_root_left = ri::read<std::string>("rendering_root_left", nh);
+    auto rendering_root_right =
+        ri::read<std::string>("rendering_root_right", nh);
+
+    std::shared_ptr<KinematicsFromURDF> urdf_kinematics(
+        new KinematicsFromURDF(robot_description,
+                               robot_description_package_path,
+                               rendering_root_left,
+                               rendering_root_right,
+                               camera_frame_id));
+
+    // the meshes are imported once, the object model and the tile renderer
+    // are both built from the flat buffers
+    auto meshes = std::make_shared<std::vector<PartMeshBuffers>>();
+    dbrt::UrdfObjectModelLoader(urdf_kinematics).load(*meshes);
+    auto object_model = std::make_shared<dbot::ObjectModel>(
+        std::make_shared<dbrt::PartMeshBuffersLoader>(meshes), false);
+
+    /* ------------------------------ */
+    /* - Our state representation   - */
+    /* ------------------------------ */
+    dbrt::RobotState<>::kinematics_ = urdf_kinematics;
+    typedef dbrt::RobotState<> State;
+
+    /* ------------------------------ */
+    /* - Robot renderer             - */
+    /* ------------------------------ */
+    // rigid_body: dbot::RigidBodyRenderer
+    // tile: multi-threaded dbrt::TileDepthRenderer
+    auto renderer_type =
+        nh.param<std::string>(prefix + "renderer", "rigid_body");
+
+    if (renderer_type == "tile")
+    {
+        auto renderer = std::make_shared<dbrt::TileDepthRenderer>(
+            *meshes,
+            camera_data->camera_matrix(),
+            camera_data->resolution().height,
+            camera_data->resolution().width);
+
+        run_emulator<State>(nh,
+                            prefix,
+                            renderer,
+                            object_model,
+                            urdf_kinematics,
+                            camera_data);
+        return 0;
+    }
+
+    auto renderer = std::make_shared<dbot::RigidBodyRenderer>(
+        object_model->vertices(),
+        object_model->triangle_indices(),
+        camera_data->camera_matrix(),
+        camera_data->resolution().height,
+        camera_data->resolution().width);
+
+    run_emulator<State>(
+        nh, prefix, renderer, object_model, urdf_kinematics, camera_data);
 
     return 0;
 }
@@ -0,0 +1,178 @@
+/*
+ * This is part of the Bayesian Object Tracking (bot),
+ * (https://github.com/bayesian-object-tracking)
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file thread_pool.h
+ * \date October 2026
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace dbrt
+{
+/**
+ * \brief Fixed number of worker threads executing submitted tasks in
+ *        submission order.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * \brief Number of hardware threads, at least 1
+     */
+    static std::size_t default_size()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    explicit ThreadPool(std::size_t thread_count = default_size())
+        : stopping_(false)
+    {
+        thread_count = std::max<std::size_t>(thread_count, 1);
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            workers_.emplace_back(&ThreadPool::run_worker, this);
+        }
+    }
+
+    /**
+     * \brief Finishes all submitted tasks and joins the workers
+     */
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+        condition_.notify_all();
+
+        for (auto& worker : workers_) worker.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t size() const { return workers_.size(); }
+
+    /**
+     * \brief Queues the function. Its result or exception is delivered
+     *        through the returned future.
+     */
+    template <typename Function>
+    auto submit(Function function) -> std::future<decltype(function())>
+    {
+        typedef decltype(function()) Result;
+
+        auto task =
+            std::make_shared<std::packaged_task<Result()>>(std::move(function));
+        std::future<Result> result = task->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.emplace_back([task]() { (*task)(); });
+        }
+        condition_.notify_one();
+
+        return result;
+    }
+
+    /**
+     * \brief Evaluates function(i) for i in [0, count) concurrently and
+     *        returns the results in index order. The first exception thrown
+     *        by any call is rethrown after all calls have finished.
+     */
+    template <typename Function>
+    auto map(std::size_t count, Function function)
+        -> std::vector<decltype(function(std::size_t(0)))>
+    {
+        typedef decltype(function(std::size_t(0))) Result;
+
+        std::vector<std::future<Result>> futures;
+        futures.reserve(count);
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            futures.push_back(submit([&function, i]() { return function(i); }));
+        }
+
+        for (auto& future : futures) future.wait();
+
+        std::vector<Result> results;
+        results.reserve(count);
+        for (auto& future : futures) results.push_back(future.get());
+
+        return results;
+    }
+
+    /**
+     * \brief Calls function(i) for i in [0, count) on all workers and waits
+     *        for all calls. The indices are handed out one at a time, so
+     *        uneven calls are balanced across the workers. The first
+     *        exception thrown by any call is rethrown.
+     */
+    template <typename Function>
+    void for_each(std::size_t count, Function function)
+    {
+        std::atomic<std::size_t> next(0);
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < count; i = next++) function(i);
+        };
+
+        std::vector<std::future<void>> futures;
+        for (std::size_t k = 0; k < std::min(size(), count); ++k)
+        {
+            futures.push_back(submit(worker));
+        }
+
+        for (auto& future : futures) future.wait();
+        for (auto& future : futures) future.get();
+    }
+
+private:
+    void run_worker()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(
+                    lock, [this]() { return stopping_ || !tasks_.empty(); });
+                if (tasks_.empty()) return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+
+            task();
+        }
+    }
+
+private:
+    std::vector<std::thread> workers_;
+    std::deque<std::function<void()>> tasks_;
+    bool stopping_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+}
@@ -0,0 +1,99 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file belief_history_find_benchmark.cpp
+ * \date October 2026
+ *
+ * Measures the cost of BeliefHistory::find() against the number of records in
+ * the history, compared with the linear scan over the records it replaced.
+ * The histories are wrapped around their ring buffer like in the tracker.
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <dbrt/util/belief_history.h>
+#include <random>
+#include <vector>
+
+namespace
+{
+const int lookup_count = 1000000;
+const int joint_count = 33;
+const int snapshot_dim = joint_count * 4;
+
+/**
+ * \brief The lookup before the binary search
+ */
+int find_linear(const dbrt::BeliefHistory& history, double timestamp)
+{
+    for (std::size_t i = 0; i < history.snapshot_count(); ++i)
+    {
+        if (history.timestamp(i) > timestamp) return int(i);
+    }
+
+    return -1;
+}
+
+template <typename Find>
+double ns_per_find(const std::vector<double>& timestamps, Find&& find)
+{
+    // keeps the lookups from being optimized away
+    volatile int sink = 0;
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookup_count; ++i)
+    {
+        sink = sink + find(timestamps[i % timestamps.size()]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           lookup_count;
+}
+}
+
+int main(int argc, char** argv)
+{
+    std::mt19937 generator(42);
+    const Eigen::VectorXd obsrv = Eigen::VectorXd::Zero(joint_count);
+
+    std::printf("%10s %14s %14s\n", "records", "binary [ns]", "linear [ns]");
+    for (int size : {10, 100, 1000, 10000})
+    {
+        // 1 kHz joint observations, pushed past the capacity once such that
+        // the records wrap around
+        dbrt::BeliefHistory history(joint_count, snapshot_dim, size);
+        const int pushed = size + size / 2;
+        for (int i = 0; i < pushed; ++i)
+        {
+            history.push_back(0.001 * i, obsrv);
+            history.commit_snapshot();
+        }
+
+        // image time stamps anywhere within the window
+        std::uniform_real_distribution<double> image_time(
+            history.timestamp(0), history.timestamp(history.size() - 1));
+        std::vector<double> timestamps(4096);
+        for (auto& timestamp : timestamps) timestamp = image_time(generator);
+
+        std::printf(
+            "%10d %14.1f %14.1f\n",
+            size,
+            ns_per_find(timestamps,
+                        [&](double t) { return history.find(t); }),
+            ns_per_find(timestamps,
+                        [&](double t) { return find_linear(history, t); }));
+    }
+
+    return 0;
+}
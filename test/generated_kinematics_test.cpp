@@ -0,0 +1,124 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file generated_kinematics_test.cpp
+ * \date October 2026
+ *
+ * Compares the forward kinematics generated at build time with the generic
+ * forward kinematics on the robot description they were generated from.
+ * Only built with DBRT_GENERATED_KINEMATICS.
+ */
+
+#include <cmath>
+#include <dbrt/kinematics_from_urdf.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <random>
+#include <sstream>
+
+namespace
+{
+const double tolerance = 1e-9;
+
+std::shared_ptr<KinematicsFromURDF> load_kinematics()
+{
+    std::ifstream urdf_file(DBRT_KINEMATICS_TEST_URDF);
+    std::stringstream robot_description;
+    robot_description << urdf_file.rdbuf();
+
+    return std::make_shared<KinematicsFromURDF>(
+        robot_description.str(),
+        DBRT_KINEMATICS_TEST_PACKAGE_PATH,
+        "",
+        "",
+        DBRT_KINEMATICS_TEST_CAMERA_FRAME,
+        false);
+}
+
+void expect_rotation_near(const Eigen::Quaterniond& expected,
+                          const Eigen::Quaterniond& actual)
+{
+    // q and -q are the same rotation
+    EXPECT_NEAR(1.0, std::fabs(expected.dot(actual)), tolerance);
+}
+}
+
+TEST(GeneratedKinematicsTest, MatchesGenericKinematics)
+{
+    auto kinematics = load_kinematics();
+    ASSERT_TRUE(kinematics->uses_generated_kinematics());
+
+    std::vector<boost::shared_ptr<PartMeshModel>> part_meshes;
+    kinematics->get_part_meshes(part_meshes);
+    const int link_count = part_meshes.size();
+    ASSERT_GT(link_count, 0);
+
+    const int state_count = 100;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> angle(-M_PI, M_PI);
+    KinematicsFromURDF::BatchMatrix joint_states(kinematics->num_joints(),
+                                                 state_count);
+    for (int i = 0; i < joint_states.size(); ++i)
+    {
+        joint_states.data()[i] = angle(generator);
+    }
+
+    // the generic batch pass over all joint states
+    KinematicsFromURDF::LinkPoseBatch batch;
+    kinematics->compute_link_poses(joint_states, batch);
+
+    // after its first full pass, the instance updates the changed subtrees
+    // with the generic kinematics
+    kinematics->set_joint_angles(
+        Eigen::VectorXd::Zero(kinematics->num_joints()));
+
+    for (int n = 0; n < state_count; ++n)
+    {
+        const Eigen::VectorXd state = joint_states.col(n);
+
+        // a fresh clone computes its first full pass with the generated code
+        auto generated = kinematics->clone();
+        generated->set_joint_angles(state);
+        kinematics->set_joint_angles(state);
+
+        for (int i = 0; i < link_count; ++i)
+        {
+            const Eigen::VectorXd position = generated->get_link_position(i);
+            const Eigen::Quaterniond orientation =
+                generated->get_link_orientation(i);
+
+            EXPECT_NEAR(
+                0.0,
+                (position - kinematics->get_link_position(i)).norm(),
+                tolerance)
+                << "link " << i << ", state " << n;
+            expect_rotation_near(kinematics->get_link_orientation(i),
+                                 orientation);
+
+            EXPECT_NEAR(batch.px(i, n), position(0), tolerance);
+            EXPECT_NEAR(batch.py(i, n), position(1), tolerance);
+            EXPECT_NEAR(batch.pz(i, n), position(2), tolerance);
+            expect_rotation_near(Eigen::Quaterniond(batch.qw(i, n),
+                                                    batch.qx(i, n),
+                                                    batch.qy(i, n),
+                                                    batch.qz(i, n)),
+                                 orientation);
+        }
+    }
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,136 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file joint_obsrv_allocation_test.cpp
+ * \date October 2026
+ *
+ * Checks that the joint observation path of the fusion tracker does not
+ * allocate once it is warmed up. The tracker is driven step by step on one
+ * thread through the joint state callback and the rotary tracker step, which
+ * includes the belief history, the batched rotary filters and the published
+ * state.
+ */
+
+#include "test_robot.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <dbrt/tracker/fusion_tracker.h>
+#include <gtest/gtest.h>
+#include <new>
+
+static std::atomic<bool> count_allocations(false);
+static std::atomic<std::size_t> allocation_count(0);
+
+void* operator new(std::size_t size)
+{
+    if (count_allocations.load(std::memory_order_relaxed))
+    {
+        allocation_count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void* memory = std::malloc(size == 0 ? 1 : size);
+    if (!memory) throw std::bad_alloc();
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete[](void* memory) noexcept
+{
+    operator delete(memory);
+}
+
+namespace
+{
+/**
+ * \brief Fusion tracker without the visual tracker. The rotary tracker step
+ *        is run by the test instead of the rotary tracker thread.
+ */
+class RotaryFusionTracker : public dbrt::FusionTracker
+{
+public:
+    explicit RotaryFusionTracker(
+        const std::shared_ptr<KinematicsFromURDF>& kinematics)
+        : dbrt::FusionTracker(
+              nullptr,
+              kinematics,
+              [kinematics]() {
+                  return dbrt::test::create_rotary_tracker(kinematics);
+              },
+              []() { return std::shared_ptr<dbrt::VisualTracker>(); },
+              0.0)
+    {
+    }
+
+    using dbrt::FusionTracker::process_joints_obsrvs;
+};
+}
+
+TEST(JointObsrvAllocationTest, SteadyStateDoesNotAllocate)
+{
+    auto kinematics = dbrt::test::create_kinematics(3, true);
+    RotaryFusionTracker tracker(kinematics);
+    tracker.initialize({dbrt::FusionTracker::State(
+        Eigen::VectorXd::Zero(kinematics->num_joints()))});
+
+    auto joint_msg = dbrt::test::joint_state_msg(*kinematics);
+
+    dbrt::FusionTracker::State current_state(kinematics->num_joints());
+    dbrt::FusionTracker::JointsObsrv current_angle_measurement(
+        kinematics->num_joints());
+    double current_time = 0;
+
+    auto step = [&](int i) {
+        joint_msg.header.stamp = ros::Time(1.0 + 0.01 * i);
+        for (int k = 0; k < joint_msg.position.size(); ++k)
+        {
+            joint_msg.position[k] = 0.1 * std::sin(0.01 * i + k);
+        }
+        tracker.joints_obsrv_callback(joint_msg);
+        tracker.process_joints_obsrvs();
+        tracker.current_things(
+            current_state, current_time, current_angle_measurement);
+    };
+
+    // warm up such that all buffers have their final size
+    for (int i = 0; i < 64; ++i) step(i);
+
+    allocation_count = 0;
+    count_allocations = true;
+    for (int i = 64; i < 1064; ++i) step(i);
+    count_allocations = false;
+
+    EXPECT_EQ(0u, allocation_count.load());
+    EXPECT_EQ(kinematics->num_joints(), current_state.size());
+    EXPECT_DOUBLE_EQ(1.0 + 0.01 * 1063, current_time);
+    EXPECT_DOUBLE_EQ(joint_msg.position[0],
+                     current_angle_measurement(
+                         kinematics->find_joint_index(joint_msg.name[0])));
+    EXPECT_EQ(0u, tracker.joints_obsrv_buffer().dropped_count());
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file joint_state_conversion_benchmark.cpp
+ * \date October 2026
+ *
+ * Measures the joint state message conversion of the joint callbacks. The
+ * previous conversion copied the message and looked up every joint with
+ * name_to_index(). It is compared with the cached layouts for one publisher
+ * and for two publishers of different layouts, both with a layout cache
+ * owned by the caller and with the locked cache of the kinematics.
+ */
+
+#include "test_robot.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+const int message_count = 200000;
+
+/**
+ * \brief The conversion before the layouts were cached
+ */
+void convert_by_name(KinematicsFromURDF& kinematics,
+                     const sensor_msgs::JointState& angles,
+                     Eigen::VectorXd& eigen)
+{
+    sensor_msgs::JointState joint_msg = angles;
+    eigen.resize(kinematics.num_joints());
+    for (int i = 0; i < joint_msg.name.size(); ++i)
+    {
+        eigen(kinematics.name_to_index(joint_msg.name[i])) =
+            joint_msg.position[i];
+    }
+}
+
+template <typename Convert>
+double ns_per_message(const std::vector<sensor_msgs::JointState>& msgs,
+                      Convert&& convert)
+{
+    // warm up, such that the layouts are cached
+    for (const auto& msg : msgs) convert(msg);
+
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < message_count; ++i)
+    {
+        convert(msgs[i % msgs.size()]);
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() /
+           message_count;
+}
+}
+
+int main(int argc, char** argv)
+{
+    auto kinematics = dbrt::test::create_kinematics(15, true);
+    Eigen::VectorXd eigen(kinematics->num_joints());
+
+    // two publishers which send all joints in different orders
+    std::mt19937 generator(42);
+    std::vector<sensor_msgs::JointState> msgs(
+        2, dbrt::test::joint_state_msg(*kinematics));
+    for (auto& msg : msgs)
+    {
+        std::shuffle(msg.name.begin(), msg.name.end(), generator);
+    }
+    const std::vector<sensor_msgs::JointState> one_layout(1, msgs[0]);
+
+    KinematicsFromURDF::JointLayoutCache layouts;
+    auto by_name = [&](const sensor_msgs::JointState& msg) {
+        convert_by_name(*kinematics, msg, eigen);
+    };
+    auto cached = [&](const sensor_msgs::JointState& msg) {
+        kinematics->sensor_msg_to_eigen(msg, eigen, layouts);
+    };
+    auto locked = [&](const sensor_msgs::JointState& msg) {
+        kinematics->sensor_msg_to_eigen(msg, eigen);
+    };
+
+    std::printf("%d robot joints, ns per message\n",
+                kinematics->num_robot_joints());
+    std::printf("%-28s %12s %12s\n", "conversion", "1 layout", "2 layouts");
+    std::printf("%-28s %12.1f %12.1f\n",
+                "copy and name_to_index",
+                ns_per_message(one_layout, by_name),
+                ns_per_message(msgs, by_name));
+    std::printf("%-28s %12.1f %12.1f\n",
+                "cached layout, caller cache",
+                ns_per_message(one_layout, cached),
+                ns_per_message(msgs, cached));
+    std::printf("%-28s %12.1f %12.1f\n",
+                "cached layout, locked cache",
+                ns_per_message(one_layout, locked),
+                ns_per_message(msgs, locked));
+
+    return 0;
+}
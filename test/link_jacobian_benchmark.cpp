@@ -0,0 +1,139 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file link_jacobian_benchmark.cpp
+ * \date October 2026
+ *
+ * Measures the analytic link pose Jacobians against central differences,
+ * which need two forward kinematics passes per joint state entry, for robots
+ * of increasing size.
+ */
+
+#include "test_robot.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+
+namespace
+{
+const int repetition_count = 200;
+
+/**
+ * \brief Jacobians of all link poses by central differences, two forward
+ *        kinematics passes per joint state entry
+ */
+void central_differences(KinematicsFromURDF& kinematics,
+                         const Eigen::VectorXd& state,
+                         std::vector<KinematicsFromURDF::LinkJacobian>& jac)
+{
+    const double step = 1e-6;
+    const int link_count = kinematics.num_links();
+
+    static std::vector<Eigen::Vector3d> positions;
+    static std::vector<Eigen::Quaterniond> orientations;
+    positions.resize(link_count);
+    orientations.resize(link_count);
+    jac.resize(link_count);
+    for (auto& jacobian : jac) jacobian.resize(6, state.size());
+
+    Eigen::VectorXd shifted = state;
+    for (int j = 0; j < state.size(); ++j)
+    {
+        shifted(j) = state(j) - step;
+        kinematics.set_joint_angles(shifted);
+        for (int i = 0; i < link_count; ++i)
+        {
+            positions[i] = kinematics.get_link_position(i);
+            orientations[i] = kinematics.get_link_orientation(i);
+        }
+
+        shifted(j) = state(j) + step;
+        kinematics.set_joint_angles(shifted);
+        for (int i = 0; i < link_count; ++i)
+        {
+            Eigen::Quaterniond difference =
+                kinematics.get_link_orientation(i) *
+                orientations[i].conjugate();
+            if (difference.w() < 0) difference.coeffs() *= -1.0;
+            const Eigen::AngleAxisd rotation(difference);
+
+            jac[i].col(j).head<3>() =
+                (kinematics.get_link_position(i) - positions[i]) / (2 * step);
+            jac[i].col(j).tail<3>() =
+                rotation.angle() * rotation.axis() / (2 * step);
+        }
+
+        shifted(j) = state(j);
+    }
+}
+}
+
+int main(int argc, char** argv)
+{
+    std::printf("%8s %8s %16s %16s %10s\n",
+                "joints",
+                "links",
+                "analytic [us]",
+                "central [us]",
+                "speedup");
+
+    for (int arm_joint_count : {3, 7, 15})
+    {
+        auto kinematics = dbrt::test::create_kinematics(arm_joint_count, true);
+
+        std::mt19937 generator(42);
+        std::uniform_real_distribution<double> angle(-1.0, 1.0);
+        Eigen::VectorXd state(kinematics->num_joints());
+        for (int j = 0; j < state.size(); ++j)
+        {
+            state(j) = 0.05 * angle(generator);
+        }
+
+        std::vector<KinematicsFromURDF::LinkJacobian> jacobians;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetition_count; ++r)
+        {
+            // move every joint such that the forward kinematics pass is
+            // part of the measurement like in the tracker
+            state(r % state.size()) += 1e-3;
+            kinematics->set_joint_angles(state);
+            kinematics->compute_link_jacobians(jacobians);
+        }
+        auto end = std::chrono::steady_clock::now();
+        const double analytic =
+            std::chrono::duration<double, std::micro>(end - start).count() /
+            repetition_count;
+
+        start = std::chrono::steady_clock::now();
+        for (int r = 0; r < repetition_count; ++r)
+        {
+            state(r % state.size()) += 1e-3;
+            central_differences(*kinematics, state, jacobians);
+        }
+        end = std::chrono::steady_clock::now();
+        const double central =
+            std::chrono::duration<double, std::micro>(end - start).count() /
+            repetition_count;
+
+        std::printf("%8d %8d %16.1f %16.1f %10.1f\n",
+                    kinematics->num_joints(),
+                    kinematics->num_links(),
+                    analytic,
+                    central,
+                    central / analytic);
+    }
+
+    return 0;
+}
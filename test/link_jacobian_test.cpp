@@ -0,0 +1,134 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file link_jacobian_test.cpp
+ * \date October 2026
+ *
+ * Compares the analytic link pose Jacobians with central differences of
+ * set_joint_angles() on a branched robot whose camera sits on a branch of its
+ * own, with and without the estimated camera offset.
+ */
+
+#include "test_robot.h"
+
+#include <gtest/gtest.h>
+#include <random>
+
+namespace
+{
+const double step = 1e-6;
+const double tolerance = 1e-6;
+
+/**
+ * \brief Central difference of the camera relative link poses for joint
+ *        state entry column, laid out like the analytic Jacobian columns
+ */
+std::vector<Eigen::Matrix<double, 6, 1>> numeric_column(
+    KinematicsFromURDF& kinematics,
+    const Eigen::VectorXd& state,
+    int column)
+{
+    const int link_count = kinematics.num_links();
+
+    std::vector<Eigen::Vector3d> positions(link_count);
+    std::vector<Eigen::Quaterniond> orientations(link_count);
+    Eigen::VectorXd shifted = state;
+    shifted(column) -= step;
+    kinematics.set_joint_angles(shifted);
+    for (int i = 0; i < link_count; ++i)
+    {
+        positions[i] = kinematics.get_link_position(i);
+        orientations[i] = kinematics.get_link_orientation(i);
+    }
+
+    std::vector<Eigen::Matrix<double, 6, 1>> twists(link_count);
+    shifted(column) = state(column) + step;
+    kinematics.set_joint_angles(shifted);
+    for (int i = 0; i < link_count; ++i)
+    {
+        // the rotation between both poses is exp([w] 2 step) with w in the
+        // camera frame. q and -q are the same rotation.
+        Eigen::Quaterniond difference =
+            kinematics.get_link_orientation(i) * orientations[i].conjugate();
+        if (difference.w() < 0) difference.coeffs() *= -1.0;
+        const Eigen::AngleAxisd rotation(difference);
+
+        twists[i].head<3>() =
+            (kinematics.get_link_position(i) - positions[i]) / (2 * step);
+        twists[i].tail<3>() =
+            rotation.angle() * rotation.axis() / (2 * step);
+    }
+
+    return twists;
+}
+
+void expect_jacobians_match_central_differences(bool use_camera_offset)
+{
+    auto kinematics = dbrt::test::create_kinematics(3, use_camera_offset);
+    const int joint_count = kinematics->num_joints();
+    const int link_count = kinematics->num_links();
+    ASSERT_GT(link_count, 0);
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> angle(-1.0, 1.0);
+
+    for (int n = 0; n < 10; ++n)
+    {
+        Eigen::VectorXd state(joint_count);
+        for (int j = 0; j < joint_count; ++j) state(j) = angle(generator);
+        if (use_camera_offset)
+        {
+            // a few centimeters and degrees
+            for (int index : kinematics->camera_offset_joint_indices())
+            {
+                state(index) *= 0.05;
+            }
+        }
+
+        std::vector<KinematicsFromURDF::LinkJacobian> jacobians;
+        kinematics->set_joint_angles(state);
+        kinematics->compute_link_jacobians(jacobians);
+        ASSERT_EQ(link_count, int(jacobians.size()));
+
+        for (int j = 0; j < joint_count; ++j)
+        {
+            const auto twists = numeric_column(*kinematics, state, j);
+            for (int i = 0; i < link_count; ++i)
+            {
+                EXPECT_NEAR(
+                    0.0, (jacobians[i].col(j) - twists[i]).norm(), tolerance)
+                    << "link " << i << ", state entry " << j
+                    << ", state " << n << "\nanalytic "
+                    << jacobians[i].col(j).transpose() << "\nnumeric  "
+                    << twists[i].transpose();
+            }
+        }
+    }
+}
+}
+
+TEST(LinkJacobianTest, MatchesCentralDifferences)
+{
+    expect_jacobians_match_central_differences(false);
+}
+
+TEST(LinkJacobianTest, MatchesCentralDifferencesWithCameraOffset)
+{
+    expect_jacobians_match_central_differences(true);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,140 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file robot_state_contention_benchmark.cpp
+ * \date October 2026
+ *
+ * Measures the link pose queries of RobotState from 1, 2, 4 and 8 threads.
+ * Every thread queries all links of its own states like the renderers do.
+ * The per thread kinematics contexts are compared with the previous scheme,
+ * in which all threads shared one kinematics instance behind a global
+ * mutex.
+ */
+
+#include "test_robot.h"
+
+#include <chrono>
+#include <cstdio>
+#include <dbrt/robot_state.h>
+#include <mutex>
+#include <random>
+#include <thread>
+
+namespace
+{
+const int states_per_thread = 2000;
+
+// keeps the pose reads from being optimized away
+volatile double sink = 0;
+
+typedef dbrt::RobotState<> State;
+
+std::vector<State> random_states(int joint_count, int seed)
+{
+    std::mt19937 generator(seed);
+    std::uniform_real_distribution<double> angle(-1.0, 1.0);
+
+    std::vector<State> states;
+    for (int i = 0; i < states_per_thread; ++i)
+    {
+        Eigen::VectorXd joints(joint_count);
+        for (int j = 0; j < joint_count; ++j) joints(j) = angle(generator);
+        states.push_back(State(joints));
+    }
+
+    return states;
+}
+
+/**
+ * \brief Runs query() on the states of thread_count threads and returns the
+ *        number of states per second
+ */
+template <typename Query>
+double states_per_second(const std::vector<std::vector<State>>& states,
+                         int thread_count,
+                         Query&& query)
+{
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < thread_count; ++t)
+    {
+        threads.emplace_back([&states, &query, t]() {
+            for (const auto& state : states[t]) query(state);
+        });
+    }
+    for (auto& thread : threads) thread.join();
+    auto end = std::chrono::steady_clock::now();
+
+    return thread_count * states_per_thread /
+           std::chrono::duration<double>(end - start).count();
+}
+}
+
+int main(int argc, char** argv)
+{
+    auto kinematics = dbrt::test::create_kinematics(7);
+    State::kinematics_ = kinematics;
+    const int link_count = kinematics->num_links();
+
+    std::vector<std::vector<State>> states;
+    for (int t = 0; t < 8; ++t)
+    {
+        states.push_back(random_states(kinematics->num_joints(), t));
+    }
+
+    // previous scheme, one shared instance behind a global mutex
+    std::mutex kinematics_mutex;
+    auto locked_query = [&](const State& state) {
+        std::lock_guard<std::mutex> lock(kinematics_mutex);
+        kinematics->set_joint_angles(state);
+        for (int i = 0; i < link_count; ++i)
+        {
+            sink = kinematics->get_link_position(i)(0) +
+                   kinematics->get_link_orientation(i).w();
+        }
+    };
+
+    // per thread kinematics contexts
+    auto context_query = [&](const State& state) {
+        for (int i = 0; i < state.count(); ++i)
+        {
+            sink = state.component(i).position()(0);
+        }
+    };
+
+    std::printf("%d links, %u hardware threads, states per second\n",
+                link_count,
+                std::thread::hardware_concurrency());
+    std::printf("%8s %14s %14s %10s\n",
+                "threads",
+                "global mutex",
+                "per thread",
+                "speedup");
+    double single_thread = 0;
+    for (int thread_count : {1, 2, 4, 8})
+    {
+        const double locked =
+            states_per_second(states, thread_count, locked_query);
+        const double contexts =
+            states_per_second(states, thread_count, context_query);
+        if (thread_count == 1) single_thread = contexts;
+
+        std::printf("%8d %14.0f %14.0f %10.2f\n",
+                    thread_count,
+                    locked,
+                    contexts,
+                    contexts / single_thread);
+    }
+
+    return 0;
+}
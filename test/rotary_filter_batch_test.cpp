@@ -0,0 +1,127 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file rotary_filter_batch_test.cpp
+ * \date October 2026
+ *
+ * Compares the batched rotary joint filters with the per joint
+ * fl::GaussianFilter instances they replace. Both are created by the same
+ * RotaryTrackerBuilder from the same transition and sensor models.
+ */
+
+#include "test_robot.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+namespace
+{
+const double tolerance = 1e-9;
+const int step_count = 500;
+
+typedef dbrt::RotaryTracker::JointFilter JointFilter;
+typedef dbrt::RotaryTracker::JointBelief JointBelief;
+typedef dbrt::RotaryTracker::JointInput JointInput;
+typedef dbrt::RotaryTracker::JointObsrv JointObsrv;
+
+void expect_near(double expected, double actual)
+{
+    EXPECT_NEAR(expected, actual, tolerance * (1.0 + std::fabs(expected)));
+}
+
+/**
+ * \brief Filters the same random observations with the per joint filters and
+ *        the batch and compares the beliefs after every step
+ */
+void expect_same_beliefs(bool vector_instructions)
+{
+    auto kinematics = dbrt::test::create_kinematics();
+    auto builder = dbrt::test::create_rotary_tracker_builder(kinematics);
+    auto joint_filters = builder.create_joint_filters();
+    auto filter_batch = builder.create_filter_batch();
+    filter_batch->vector_instructions(vector_instructions);
+
+    const int joint_count = kinematics->num_robot_joints();
+    ASSERT_EQ(joint_count, int(joint_filters->size()));
+    ASSERT_EQ(joint_count, filter_batch->joint_count());
+
+    std::mt19937 generator(42);
+    std::normal_distribution<double> normal(0.0, 1.0);
+
+    // correlated initial beliefs which differ from joint to joint
+    std::vector<JointBelief> beliefs;
+    for (int i = 0; i < joint_count; ++i)
+    {
+        Eigen::Vector2d mean(normal(generator), 0.1 * normal(generator));
+        Eigen::Matrix2d covariance;
+        covariance << 0.1 + 0.01 * i, 0.005, 0.005, 0.01;
+
+        beliefs.push_back((*joint_filters)[i].create_belief());
+        beliefs[i].mean(mean);
+        beliefs[i].covariance(covariance);
+        filter_batch->set_belief(i, mean, covariance);
+    }
+
+    Eigen::VectorXd obsrv(joint_count);
+    for (int step = 0; step < step_count; ++step)
+    {
+        for (int i = 0; i < joint_count; ++i)
+        {
+            obsrv(i) = std::sin(0.01 * step + i) + 0.002 * normal(generator);
+        }
+
+        for (int i = 0; i < joint_count; ++i)
+        {
+            (*joint_filters)[i].predict(
+                beliefs[i], JointInput::Zero(), beliefs[i]);
+            (*joint_filters)[i].update(
+                beliefs[i], JointObsrv(obsrv(i)), beliefs[i]);
+        }
+        filter_batch->predict_and_update(obsrv);
+
+        for (int i = 0; i < joint_count; ++i)
+        {
+            Eigen::Vector2d mean;
+            Eigen::Matrix2d covariance;
+            filter_batch->belief(i, mean, covariance);
+
+            SCOPED_TRACE(testing::Message() << "joint " << i << ", step "
+                                            << step);
+            expect_near(beliefs[i].mean()(0), mean(0));
+            expect_near(beliefs[i].mean()(1), mean(1));
+            expect_near(beliefs[i].covariance()(0, 0), covariance(0, 0));
+            expect_near(beliefs[i].covariance()(0, 1), covariance(0, 1));
+            expect_near(beliefs[i].covariance()(1, 1), covariance(1, 1));
+        }
+    }
+}
+}
+
+TEST(RotaryFilterBatchTest, ScalarMatchesJointFilters)
+{
+    expect_same_beliefs(false);
+}
+
+#ifdef __AVX2__
+TEST(RotaryFilterBatchTest, Avx2MatchesJointFilters)
+{
+    expect_same_beliefs(true);
+}
+#endif
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
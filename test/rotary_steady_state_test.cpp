@@ -0,0 +1,231 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file rotary_steady_state_test.cpp
+ * \date October 2026
+ *
+ * Checks the steady state mode of the rotary joint filters: convergence, the
+ * mean only update with the converged gains and the return to the full
+ * update after the beliefs are corrected.
+ */
+
+#include "test_robot.h"
+
+#include <cmath>
+#include <gtest/gtest.h>
+
+namespace
+{
+const double steady_state_tolerance = 1e-12;
+const int max_step_count = 5000;
+
+double obsrv_at(int step, int joint)
+{
+    return 0.5 * std::sin(0.003 * step + joint);
+}
+
+/**
+ * \brief Runs step_filters() on the observations of consecutive steps until
+ *        the batch reports the steady state. Returns the number of steps or
+ *        -1 if the batch did not converge.
+ */
+template <typename StepFilters>
+int run_until_steady_state(const dbrt::RotaryFilterBatch& batch,
+                           StepFilters&& step_filters,
+                           int& step)
+{
+    Eigen::VectorXd obsrv(batch.joint_count());
+    for (int i = 0; i < max_step_count; ++i, ++step)
+    {
+        for (int j = 0; j < obsrv.size(); ++j) obsrv(j) = obsrv_at(step, j);
+        step_filters(obsrv);
+        if (batch.steady_state()) return i + 1;
+    }
+
+    return -1;
+}
+}
+
+TEST(RotarySteadyStateTest, ConvergesAndUpdatesTheMeansWithFixedGains)
+{
+    const int joint_count = 5;
+
+    // angle and bias of joints with different dynamics and noise, the sensor
+    // observes the biased angle
+    std::vector<Eigen::Matrix2d> dynamics(joint_count);
+    std::vector<Eigen::Matrix2d> noise_covariances(joint_count);
+    const Eigen::RowVector2d sensor(1.0, 1.0);
+    std::vector<double> sensor_variances(joint_count);
+
+    dbrt::RotaryFilterBatch batch(joint_count);
+    dbrt::RotaryFilterBatch reference(joint_count);
+    for (int j = 0; j < joint_count; ++j)
+    {
+        dynamics[j] << 1.0, 0.0, 0.0, 0.8 + 0.02 * j;
+        noise_covariances[j] << 1e-4 * (j + 1), 0.0, 0.0, 1e-6;
+        sensor_variances[j] = 4e-6 * (j + 1);
+
+        for (auto* filters : {&batch, &reference})
+        {
+            filters->set_joint_model(j,
+                                     dynamics[j],
+                                     noise_covariances[j],
+                                     sensor,
+                                     sensor_variances[j]);
+            filters->set_belief(
+                j, Eigen::Vector2d::Zero(), Eigen::Matrix2d::Identity());
+        }
+    }
+    batch.steady_state_tolerance(steady_state_tolerance);
+
+    auto step_batches = [&](const Eigen::VectorXd& obsrv) {
+        batch.predict_and_update(obsrv);
+        reference.predict_and_update(obsrv);
+    };
+
+    int step = 0;
+    ASSERT_GT(run_until_steady_state(batch, step_batches, step), 0);
+
+    // converged gains K = P H^T / (H P H^T + r) of the predicted covariance
+    std::vector<Eigen::Vector2d> gains(joint_count);
+    std::vector<Eigen::Matrix2d> covariances(joint_count);
+    for (int j = 0; j < joint_count; ++j)
+    {
+        Eigen::Vector2d mean;
+        batch.belief(j, mean, covariances[j]);
+
+        const Eigen::Matrix2d predicted =
+            dynamics[j] * covariances[j] * dynamics[j].transpose() +
+            noise_covariances[j];
+        gains[j] = predicted * sensor.transpose() /
+                   ((sensor * predicted * sensor.transpose())(0, 0) +
+                    sensor_variances[j]);
+    }
+
+    Eigen::VectorXd obsrv(joint_count);
+    for (int i = 0; i < 100; ++i, ++step)
+    {
+        std::vector<Eigen::Vector2d> priors(joint_count);
+        for (int j = 0; j < joint_count; ++j)
+        {
+            Eigen::Matrix2d covariance;
+            batch.belief(j, priors[j], covariance);
+            obsrv(j) = obsrv_at(step, j);
+        }
+
+        batch.predict_and_update(obsrv);
+        reference.predict_and_update(obsrv);
+        ASSERT_TRUE(batch.steady_state());
+
+        for (int j = 0; j < joint_count; ++j)
+        {
+            Eigen::Vector2d mean, reference_mean;
+            Eigen::Matrix2d covariance, reference_covariance;
+            batch.belief(j, mean, covariance);
+            reference.belief(j, reference_mean, reference_covariance);
+
+            // m = A m + K (z - H A m)
+            const Eigen::Vector2d predicted = dynamics[j] * priors[j];
+            const Eigen::Vector2d expected =
+                predicted +
+                gains[j] * (obsrv(j) - (sensor * predicted)(0, 0));
+
+            EXPECT_NEAR(0.0, (expected - mean).norm(), 1e-12);
+            EXPECT_TRUE(covariance == covariances[j]);
+
+            // the full update does not move the covariances any more either
+            EXPECT_NEAR(0.0, (reference_mean - mean).norm(), 1e-9);
+            EXPECT_NEAR(
+                0.0, (reference_covariance - covariance).norm(), 1e-9);
+        }
+    }
+}
+
+TEST(RotarySteadyStateTest, FallsBackToTheFullUpdateAfterSetAngleBeliefs)
+{
+    auto kinematics = dbrt::test::create_kinematics();
+    auto builder = dbrt::test::create_rotary_tracker_builder(kinematics);
+
+    // the tracker under test and a reference which always runs the full
+    // update
+    auto batch = builder.create_filter_batch();
+    auto reference_batch = builder.create_filter_batch();
+    dbrt::RotaryTracker tracker(
+        builder.create_joint_filters(), batch, kinematics);
+    dbrt::RotaryTracker reference(
+        builder.create_joint_filters(), reference_batch, kinematics);
+
+    const dbrt::RotaryTracker::State initial_state =
+        Eigen::VectorXd::Zero(kinematics->num_joints());
+    tracker.initialize({initial_state});
+    reference.initialize({initial_state});
+    tracker.steady_state_tolerance(steady_state_tolerance);
+
+    dbrt::RotaryTracker::State state, reference_state;
+    auto step_trackers = [&](const Eigen::VectorXd& obsrv) {
+        tracker.track(obsrv, state);
+        reference.track(obsrv, reference_state);
+    };
+
+    int step = 0;
+    ASSERT_GT(run_until_steady_state(*batch, step_trackers, step), 0);
+
+    // a visual correction
+    auto angle_beliefs = tracker.angle_beliefs();
+    for (auto& angle_belief : angle_beliefs)
+    {
+        auto angle_mean = angle_belief.mean();
+        auto angle_covariance = angle_belief.covariance();
+        angle_mean(0) += 0.1;
+        angle_covariance(0, 0) *= 4.0;
+        angle_belief.mean(angle_mean);
+        angle_belief.covariance(angle_covariance);
+    }
+    tracker.set_angle_beliefs(angle_beliefs);
+    reference.set_angle_beliefs(angle_beliefs);
+    EXPECT_FALSE(batch->steady_state());
+
+    // the covariances are propagated again until they converge anew
+    Eigen::Vector2d mean;
+    Eigen::Matrix2d corrected_covariance, covariance;
+    batch->belief(0, mean, corrected_covariance);
+
+    Eigen::VectorXd obsrv(kinematics->num_joints());
+    for (int j = 0; j < obsrv.size(); ++j) obsrv(j) = obsrv_at(step, j);
+    step_trackers(obsrv);
+    ++step;
+
+    batch->belief(0, mean, covariance);
+    EXPECT_FALSE(batch->steady_state());
+    EXPECT_GT((covariance - corrected_covariance).norm(),
+              0.1 * corrected_covariance.norm());
+
+    ASSERT_GT(run_until_steady_state(*batch, step_trackers, step), 0);
+    EXPECT_NEAR(0.0, (reference_state - state).norm(), 1e-9);
+    for (int j = 0; j < batch->joint_count(); ++j)
+    {
+        Eigen::Vector2d reference_mean;
+        Eigen::Matrix2d reference_covariance;
+        batch->belief(j, mean, covariance);
+        reference_batch->belief(j, reference_mean, reference_covariance);
+
+        EXPECT_NEAR(0.0, (reference_mean - mean).norm(), 1e-9);
+        EXPECT_NEAR(0.0, (reference_covariance - covariance).norm(), 1e-9);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,179 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file rotary_wake_up_benchmark.cpp
+ * \date October 2026
+ *
+ * Measures the CPU time the rotary tracker thread burns while no joint
+ * observations arrive, and the latency from the joint state callback to the
+ * published estimate. The thread which sleeps until it is woken is compared
+ * with the previous thread which polled the incoming buffer every 10 us.
+ */
+
+#include "test_robot.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <dbrt/tracker/fusion_tracker.h>
+#include <thread>
+#include <unistd.h>
+
+namespace
+{
+const int latency_sample_count = 2000;
+
+class RotaryFusionTracker : public dbrt::FusionTracker
+{
+public:
+    explicit RotaryFusionTracker(
+        const std::shared_ptr<KinematicsFromURDF>& kinematics)
+        : dbrt::FusionTracker(
+              nullptr,
+              kinematics,
+              [kinematics]() {
+                  return dbrt::test::create_rotary_tracker(kinematics);
+              },
+              []() { return std::shared_ptr<dbrt::VisualTracker>(); },
+              0.0)
+    {
+    }
+
+    using dbrt::FusionTracker::run_rotary_tracker;
+    using dbrt::FusionTracker::process_joints_obsrvs;
+};
+
+double process_cpu_seconds()
+{
+    timespec time;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &time);
+    return time.tv_sec + 1e-9 * time.tv_nsec;
+}
+
+struct Result
+{
+    double idle_cpu_percent;
+    double median_latency_us;
+    double p99_latency_us;
+};
+
+/**
+ * \brief Runs the rotary thread returned by start(), measures it and stops
+ *        it with stop()
+ */
+template <typename Start, typename Stop>
+Result measure(const std::shared_ptr<KinematicsFromURDF>& kinematics,
+               Start&& start,
+               Stop&& stop)
+{
+    RotaryFusionTracker tracker(kinematics);
+    tracker.initialize({dbrt::FusionTracker::State(
+        Eigen::VectorXd::Zero(kinematics->num_joints()))});
+    std::thread rotary_thread = start(tracker);
+
+    auto joint_msg = dbrt::test::joint_state_msg(*kinematics);
+    dbrt::FusionTracker::State current_state;
+    dbrt::FusionTracker::JointsObsrv current_angle_measurement;
+    double current_time = 0;
+
+    // idle
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    const double cpu_start = process_cpu_seconds();
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    const double idle_cpu = (process_cpu_seconds() - cpu_start) / 2.0;
+
+    // joint observation to published estimate
+    std::vector<double> latencies;
+    for (int i = 0; i < latency_sample_count; ++i)
+    {
+        const double timestamp = 1.0 + 0.001 * i;
+        joint_msg.header.stamp = ros::Time(timestamp);
+
+        auto sent = std::chrono::steady_clock::now();
+        tracker.joints_obsrv_callback(joint_msg);
+        do
+        {
+            std::this_thread::yield();
+            tracker.current_things(
+                current_state, current_time, current_angle_measurement);
+        } while (current_time != timestamp);
+        auto published = std::chrono::steady_clock::now();
+
+        latencies.push_back(
+            std::chrono::duration<double, std::micro>(published - sent)
+                .count());
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    stop(tracker);
+    rotary_thread.join();
+
+    std::sort(latencies.begin(), latencies.end());
+    return {100.0 * idle_cpu,
+            latencies[latencies.size() / 2],
+            latencies[latencies.size() * 99 / 100]};
+}
+}
+
+int main(int argc, char** argv)
+{
+    auto kinematics = dbrt::test::create_kinematics();
+
+    // previous rotary thread, polling the incoming buffer
+    std::atomic<bool> polling(true);
+    Result before = measure(
+        kinematics,
+        [&polling](RotaryFusionTracker& tracker) {
+            return std::thread([&polling, &tracker]() {
+                while (polling)
+                {
+                    if (tracker.joints_obsrv_buffer().empty())
+                    {
+                        usleep(10);
+                        continue;
+                    }
+                    tracker.process_joints_obsrvs();
+                }
+            });
+        },
+        [&polling](RotaryFusionTracker&) { polling = false; });
+
+    // current rotary thread, sleeping on the eventfd
+    Result after = measure(
+        kinematics,
+        [](RotaryFusionTracker& tracker) {
+            return std::thread(&RotaryFusionTracker::run_rotary_tracker,
+                               &tracker);
+        },
+        [](RotaryFusionTracker& tracker) { tracker.shutdown(); });
+
+    std::printf("%-16s %14s %16s %14s\n",
+                "rotary thread",
+                "idle CPU [%]",
+                "median lat [us]",
+                "p99 lat [us]");
+    std::printf("%-16s %14.2f %16.1f %14.1f\n",
+                "polling 10 us",
+                before.idle_cpu_percent,
+                before.median_latency_us,
+                before.p99_latency_us);
+    std::printf("%-16s %14.2f %16.1f %14.1f\n",
+                "woken",
+                after.idle_cpu_percent,
+                after.median_latency_us,
+                after.p99_latency_us);
+
+    return 0;
+}
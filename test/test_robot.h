@@ -0,0 +1,241 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file test_robot.h
+ * \date October 2026
+ *
+ * Robot model shared by the tests and benchmarks
+ */
+
+#pragma once
+
+#include <boost/filesystem.hpp>
+#include <cstdlib>
+#include <dbrt/builder/rotary_tracker_builder.h>
+#include <dbrt/kinematics_from_urdf.h>
+#include <dbrt/tracker/rotary_tracker.h>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sensor_msgs/JointState.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace dbrt
+{
+namespace test
+{
+/**
+ * \brief Creates a package directory holding meshes/box.stl, a cube of
+ *        0.1 m side length centered at the origin, once per process and
+ *        returns its path
+ */
+inline const std::string& mesh_package()
+{
+    static const std::string path = []() {
+        char directory[] = "/tmp/dbrt_test_XXXXXX";
+        if (!mkdtemp(directory))
+        {
+            std::cerr << "Cannot create the test mesh package" << std::endl;
+            exit(-1);
+        }
+        boost::filesystem::create_directory(std::string(directory) +
+                                            "/meshes");
+
+        // two triangles per face, the face normal n spans with u and v
+        const int faces[6][9] = {{1, 0, 0, 0, 1, 0, 0, 0, 1},
+                                 {-1, 0, 0, 0, 0, 1, 0, 1, 0},
+                                 {0, 1, 0, 0, 0, 1, 1, 0, 0},
+                                 {0, -1, 0, 1, 0, 0, 0, 0, 1},
+                                 {0, 0, 1, 1, 0, 0, 0, 1, 0},
+                                 {0, 0, -1, 0, 1, 0, 1, 0, 0}};
+        const double h = 0.05;
+        std::ofstream stl(std::string(directory) + "/meshes/box.stl");
+        stl << "solid box\n";
+        for (const auto& f : faces)
+        {
+            const int corners[4][2] = {{-1, -1}, {1, -1}, {1, 1}, {-1, 1}};
+            const int triangles[2][3] = {{0, 1, 2}, {0, 2, 3}};
+            for (const auto& triangle : triangles)
+            {
+                stl << "facet normal " << f[0] << " " << f[1] << " " << f[2]
+                    << "\n outer loop\n";
+                for (int c : triangle)
+                {
+                    stl << "  vertex";
+                    for (int k = 0; k < 3; ++k)
+                    {
+                        stl << " "
+                            << h * (f[k] + corners[c][0] * f[3 + k] +
+                                    corners[c][1] * f[6 + k]);
+                    }
+                    stl << "\n";
+                }
+                stl << " endloop\nendfacet\n";
+            }
+        }
+        stl << "endsolid box\n";
+
+        return std::string(directory);
+    }();
+
+    return path;
+}
+
+/**
+ * \brief URDF of the test robot. A prismatic torso lift carries a pan and
+ *        tilt head with the camera and two arms of arm_joint_count revolute
+ *        joints each, so the tree branches three ways. Every arm link
+ *        carries the box mesh of mesh_package().
+ */
+inline std::string robot_description(int arm_joint_count = 3)
+{
+    const char* axes[] = {"0 0 1", "0 1 0", "1 0 0"};
+
+    std::ostringstream urdf;
+    urdf << "<robot name=\"dbrt_test\">"
+         << "<link name=\"base_link\"/>"
+         << "<link name=\"torso\"/>"
+         << "<joint name=\"torso_lift\" type=\"prismatic\">"
+         << "<parent link=\"base_link\"/><child link=\"torso\"/>"
+         << "<origin xyz=\"0 0 0.5\" rpy=\"0 0 0\"/><axis xyz=\"0 0 1\"/>"
+         << "<limit lower=\"-1\" upper=\"1\" effort=\"1\" velocity=\"1\"/>"
+         << "</joint>"
+         << "<link name=\"head_pan_link\"/>"
+         << "<joint name=\"head_pan\" type=\"revolute\">"
+         << "<parent link=\"torso\"/><child link=\"head_pan_link\"/>"
+         << "<origin xyz=\"0 0 0.4\" rpy=\"0 0 0\"/><axis xyz=\"0 0 1\"/>"
+         << "<limit lower=\"-3\" upper=\"3\" effort=\"1\" velocity=\"1\"/>"
+         << "</joint>"
+         << "<link name=\"head_tilt_link\"/>"
+         << "<joint name=\"head_tilt\" type=\"revolute\">"
+         << "<parent link=\"head_pan_link\"/>"
+         << "<child link=\"head_tilt_link\"/>"
+         << "<origin xyz=\"0.05 0 0.1\" rpy=\"0 0.3 0\"/><axis xyz=\"0 1 0\"/>"
+         << "<limit lower=\"-3\" upper=\"3\" effort=\"1\" velocity=\"1\"/>"
+         << "</joint>"
+         << "<link name=\"camera_link\"/>"
+         << "<joint name=\"camera_mount\" type=\"fixed\">"
+         << "<parent link=\"head_tilt_link\"/><child link=\"camera_link\"/>"
+         << "<origin xyz=\"0.05 0 0\" rpy=\"-1.5708 0 -1.5708\"/>"
+         << "</joint>";
+
+    for (const char* side : {"left", "right"})
+    {
+        const double y = std::string(side) == "left" ? 0.2 : -0.2;
+        std::string parent = "torso";
+        for (int i = 0; i < arm_joint_count; ++i)
+        {
+            const std::string link = std::string(side) + "_link_" +
+                                     std::to_string(i);
+            urdf << "<link name=\"" << link << "\"><visual>"
+                 << "<origin xyz=\"0.1 0 0\" rpy=\"0 0 0\"/><geometry>"
+                 << "<mesh filename=\"package://dbrt_test/meshes/box.stl\"/>"
+                 << "</geometry></visual></link>"
+                 << "<joint name=\"" << side << "_joint_" << i
+                 << "\" type=\"revolute\">"
+                 << "<parent link=\"" << parent << "\"/>"
+                 << "<child link=\"" << link << "\"/>"
+                 << "<origin xyz=\"" << (i == 0 ? 0.3 : 0.2) << " "
+                 << (i == 0 ? y : 0.0) << " 0\" rpy=\"0.1 0 0\"/>"
+                 << "<axis xyz=\"" << axes[i % 3] << "\"/>"
+                 << "<limit lower=\"-3\" upper=\"3\" effort=\"1\" "
+                 << "velocity=\"1\"/></joint>";
+            parent = link;
+        }
+    }
+    urdf << "</robot>";
+
+    return urdf.str();
+}
+
+/**
+ * \brief Kinematics of the test robot with the link meshes loaded
+ */
+inline std::shared_ptr<KinematicsFromURDF> create_kinematics(
+    int arm_joint_count = 3,
+    bool use_camera_offset = false)
+{
+    auto kinematics = std::make_shared<KinematicsFromURDF>(
+        robot_description(arm_joint_count),
+        mesh_package(),
+        "",
+        "",
+        "camera_link",
+        use_camera_offset);
+
+    std::vector<boost::shared_ptr<PartMeshModel>> part_meshes;
+    kinematics->get_part_meshes(part_meshes);
+
+    return kinematics;
+}
+
+/**
+ * \brief Joint state message of all robot joints in state order
+ */
+inline sensor_msgs::JointState joint_state_msg(
+    const KinematicsFromURDF& kinematics)
+{
+    sensor_msgs::JointState joint_msg;
+    joint_msg.name.assign(
+        kinematics.get_joint_map().begin(),
+        kinematics.get_joint_map().begin() + kinematics.num_robot_joints());
+    joint_msg.position.assign(joint_msg.name.size(), 0.0);
+
+    return joint_msg;
+}
+
+/**
+ * \brief Rotary tracker builder of all robot joints with fixed noise
+ *        parameters
+ */
+inline RotaryTrackerBuilder<RotaryTracker> create_rotary_tracker_builder(
+    const std::shared_ptr<KinematicsFromURDF>& kinematics)
+{
+    typedef RotaryTracker Tracker;
+
+    const int joint_count = kinematics->num_robot_joints();
+
+    FactorizedTransitionBuilder<Tracker>::Parameters transition_parameters;
+    transition_parameters.joint_sigmas.assign(joint_count, 0.01);
+    transition_parameters.bias_sigmas.assign(joint_count, 0.001);
+    transition_parameters.bias_factors.assign(joint_count, 0.9);
+    transition_parameters.joint_count = joint_count;
+
+    RotarySensorBuilder<Tracker>::Parameters sensor_parameters;
+    sensor_parameters.joint_sigmas.assign(joint_count, 0.002);
+    sensor_parameters.joint_count = joint_count;
+
+    return RotaryTrackerBuilder<Tracker>(
+        kinematics,
+        std::make_shared<FactorizedTransitionBuilder<Tracker>>(
+            transition_parameters),
+        std::make_shared<RotarySensorBuilder<Tracker>>(sensor_parameters));
+}
+
+/**
+ * \brief Rotary tracker of create_rotary_tracker_builder(), initialized at
+ *        the zero state
+ */
+inline std::shared_ptr<RotaryTracker> create_rotary_tracker(
+    const std::shared_ptr<KinematicsFromURDF>& kinematics)
+{
+    auto tracker = create_rotary_tracker_builder(kinematics).build();
+    tracker->initialize({RotaryTracker::State(
+        Eigen::VectorXd::Zero(kinematics->num_joints()))});
+
+    return tracker;
+}
+}
+}
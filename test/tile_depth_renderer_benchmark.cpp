@@ -0,0 +1,163 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file tile_depth_renderer_benchmark.cpp
+ * \date October 2026
+ *
+ * Measures the frame rate of TileDepthRenderer at the camera resolutions of
+ * the downsampling factors 8, 4, 2 and 1, single threaded and with the
+ * default number of threads. The scene consists of 14 link meshes of 2048
+ * triangles each, which cover a large part of the image like an arm in front
+ * of the camera. The intrinsics are scaled with the resolution.
+ */
+
+#include <dbrt/tile_depth_renderer.h>
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+namespace
+{
+const int frame_count = 200;
+const int link_count = 14;
+
+// keeps the depth images from being optimized away
+volatile float sink = 0;
+
+typedef dbrt::TileDepthRenderer::LinkPose LinkPose;
+
+/**
+ * \brief Sphere of the given radius with 2 * rings * segments triangles
+ */
+PartMeshBuffers sphere_mesh(float radius, int rings, int segments)
+{
+    PartMeshBuffers mesh;
+    for (int r = 0; r <= rings; ++r)
+    {
+        const float polar = M_PI * r / rings;
+        for (int s = 0; s < segments; ++s)
+        {
+            const float azimuth = 2 * M_PI * s / segments;
+            mesh.vertices.push_back(radius * std::sin(polar) *
+                                    std::cos(azimuth));
+            mesh.vertices.push_back(radius * std::sin(polar) *
+                                    std::sin(azimuth));
+            mesh.vertices.push_back(radius * std::cos(polar));
+        }
+    }
+
+    for (int r = 0; r < rings; ++r)
+    {
+        for (int s = 0; s < segments; ++s)
+        {
+            const std::uint32_t a = r * segments + s;
+            const std::uint32_t b = r * segments + (s + 1) % segments;
+            const std::uint32_t c = a + segments;
+            const std::uint32_t d = b + segments;
+            mesh.indices.insert(mesh.indices.end(), {a, b, d, a, d, c});
+        }
+    }
+
+    mesh.update_bounding_sphere();
+    return mesh;
+}
+
+/**
+ * \brief Link poses of the frames, two rows of links which sway slightly
+ *        from frame to frame
+ */
+std::vector<std::vector<LinkPose>> frame_poses()
+{
+    std::vector<std::vector<LinkPose>> frames(frame_count);
+    for (int f = 0; f < frame_count; ++f)
+    {
+        const float sway = 0.02f * std::sin(0.1f * f);
+        for (int i = 0; i < link_count; ++i)
+        {
+            LinkPose pose = {{1, 0, 0, -0.45f + 0.15f * (i / 2) + sway,
+                              0, 1, 0, i % 2 ? 0.12f : -0.12f,
+                              0, 0, 1, 0.9f + 0.02f * i},
+                             {0, 0, 0, 1}};
+            frames[f].push_back(pose);
+        }
+    }
+
+    return frames;
+}
+
+double frames_per_second(dbrt::TileDepthRenderer& renderer,
+                         const std::vector<std::vector<LinkPose>>& frames)
+{
+    std::vector<float> depth;
+
+    // the first frame allocates the depth image and wakes the threads up
+    renderer.render(frames[0], depth, 0.f);
+
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& poses : frames)
+    {
+        renderer.render(poses, depth, 0.f);
+        sink = sink + depth[depth.size() / 2];
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    return frames.size() / std::chrono::duration<double>(end - start).count();
+}
+}
+
+int main(int argc, char** argv)
+{
+    const std::vector<PartMeshBuffers> meshes(link_count,
+                                              sphere_mesh(0.08f, 32, 32));
+    const auto frames = frame_poses();
+    const std::size_t thread_count = dbrt::ThreadPool::default_size();
+
+    std::printf("%d links, %d triangles, frames per second\n",
+                link_count,
+                int(link_count * meshes[0].triangle_count()));
+    std::printf("%12s %12s %12s %10s\n",
+                "resolution",
+                "1 thread",
+                "threads",
+                "speedup");
+    for (int factor : {8, 4, 2, 1})
+    {
+        const int n_rows = 480 / factor;
+        const int n_cols = 640 / factor;
+
+        Eigen::Matrix3d camera_matrix;
+        camera_matrix << 525.0 / factor, 0.0, (n_cols - 1) / 2.0, 0.0,
+            525.0 / factor, (n_rows - 1) / 2.0, 0.0, 0.0, 1.0;
+
+        dbrt::TileDepthRenderer single(
+            meshes, camera_matrix, n_rows, n_cols, 1);
+        dbrt::TileDepthRenderer multi(
+            meshes, camera_matrix, n_rows, n_cols, thread_count);
+
+        const double single_fps = frames_per_second(single, frames);
+        const double multi_fps = frames_per_second(multi, frames);
+
+        char resolution[16];
+        std::snprintf(resolution, sizeof(resolution), "%dx%d", n_cols, n_rows);
+        std::printf("%12s %12.0f %12.0f %10.2f\n",
+                    resolution,
+                    single_fps,
+                    multi_fps,
+                    multi_fps / single_fps);
+    }
+    std::printf("%zu threads\n", thread_count);
+
+    return 0;
+}
@@ -0,0 +1,263 @@
+/*
+ * This is part of the Bayesian Robot Tracking
+ *
+ * Copyright (c) 2015 Max Planck Society,
+ * 				 Autonomous Motion Department,
+ * 			     Institute for Intelligent Systems
+ *
+ * This Source Code Form is subject to the terms of the GNU General Public
+ * License License (GNU GPL). A copy of the license can be found in the LICENSE
+ * file distributed with this source code.
+ */
+
+/**
+ * \file tile_depth_renderer_test.cpp
+ * \date October 2026
+ *
+ * Compares the depth images of TileDepthRenderer with the analytic depths of
+ * ray casts against boxes at known poses. The image size is not a multiple of
+ * the tile size, such that partial tiles are covered as well.
+ */
+
+#include <dbrt/tile_depth_renderer.h>
+
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+
+namespace
+{
+typedef dbrt::TileDepthRenderer::LinkPose LinkPose;
+
+const int n_rows = 110;
+const int n_cols = 150;
+const float bad_value = -1.f;
+const double tolerance = 1e-4;
+
+// pixels whose ray passes this close to a box silhouette are not compared
+const double silhouette_margin = 0.05;
+
+const Eigen::Vector3d half_extents(0.1, 0.06, 0.08);
+
+struct Box
+{
+    Eigen::Matrix3d rotation;
+    Eigen::Vector3d position;
+};
+
+Eigen::Matrix3d camera_matrix()
+{
+    Eigen::Matrix3d matrix;
+    matrix << 120.0, 0.0, 74.5, 0.0, 125.0, 54.5, 0.0, 0.0, 1.0;
+    return matrix;
+}
+
+/**
+ * \brief Box of the given half extents centered at the link origin, two
+ *        triangles per face
+ */
+PartMeshBuffers box_mesh()
+{
+    PartMeshBuffers mesh;
+    for (int corner = 0; corner < 8; ++corner)
+    {
+        mesh.vertices.push_back(corner & 1 ? half_extents(0)
+                                           : -half_extents(0));
+        mesh.vertices.push_back(corner & 2 ? half_extents(1)
+                                           : -half_extents(1));
+        mesh.vertices.push_back(corner & 4 ? half_extents(2)
+                                           : -half_extents(2));
+    }
+
+    // corners of the faces -x, +x, -y, +y, -z, +z in cyclic order
+    const std::uint32_t faces[6][4] = {{0, 2, 6, 4},
+                                       {1, 3, 7, 5},
+                                       {0, 1, 5, 4},
+                                       {2, 3, 7, 6},
+                                       {0, 1, 3, 2},
+                                       {4, 5, 7, 6}};
+    for (const auto& face : faces)
+    {
+        mesh.indices.insert(mesh.indices.end(), {face[0], face[1], face[2]});
+        mesh.indices.insert(mesh.indices.end(), {face[0], face[2], face[3]});
+    }
+
+    mesh.update_bounding_sphere();
+    return mesh;
+}
+
+LinkPose link_pose(const Box& box)
+{
+    LinkPose pose;
+    for (int row = 0; row < 3; ++row)
+    {
+        for (int col = 0; col < 3; ++col)
+        {
+            pose.affine[4 * row + col] = box.rotation(row, col);
+        }
+        pose.affine[4 * row + 3] = box.position(row);
+    }
+
+    const Eigen::Quaterniond quaternion(box.rotation);
+    pose.quaternion[0] = quaternion.x();
+    pose.quaternion[1] = quaternion.y();
+    pose.quaternion[2] = quaternion.z();
+    pose.quaternion[3] = quaternion.w();
+    return pose;
+}
+
+/**
+ * \brief Camera z of the nearest intersection of the ray through the image
+ *        point (u, v) with the box or infinity if the ray misses it. The ray
+ *        direction has a z of 1, such that the ray parameter is the depth.
+ */
+double cast_ray(const Box& box, double u, double v)
+{
+    const Eigen::Matrix3d K = camera_matrix();
+    const Eigen::Vector3d direction(
+        (u - K(0, 2)) / K(0, 0), (v - K(1, 2)) / K(1, 1), 1.0);
+
+    // slab intersection in the box frame
+    const Eigen::Vector3d origin = -box.rotation.transpose() * box.position;
+    const Eigen::Vector3d box_direction = box.rotation.transpose() * direction;
+
+    double t_near = -std::numeric_limits<double>::infinity();
+    double t_far = std::numeric_limits<double>::infinity();
+    for (int i = 0; i < 3; ++i)
+    {
+        const double t0 = (-half_extents(i) - origin(i)) / box_direction(i);
+        const double t1 = (half_extents(i) - origin(i)) / box_direction(i);
+        t_near = std::max(t_near, std::min(t0, t1));
+        t_far = std::min(t_far, std::max(t0, t1));
+    }
+
+    if (t_near > t_far || t_near <= 0.0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return t_near;
+}
+
+double cast_ray(const std::vector<Box>& boxes, double u, double v)
+{
+    double depth = std::numeric_limits<double>::infinity();
+    for (const auto& box : boxes) depth = std::min(depth, cast_ray(box, u, v));
+    return depth;
+}
+
+/**
+ * \brief Renders the boxes with each thread count and compares all pixels
+ *        away from the silhouettes with the ray casts. Returns the number of
+ *        covered pixels which have been compared.
+ */
+int expect_analytic_depths(const std::vector<Box>& boxes)
+{
+    std::vector<PartMeshBuffers> meshes(boxes.size(), box_mesh());
+    std::vector<LinkPose> poses;
+    for (const auto& box : boxes) poses.push_back(link_pose(box));
+
+    int covered_count = 0;
+    for (std::size_t thread_count : {1, 4})
+    {
+        dbrt::TileDepthRenderer renderer(
+            meshes, camera_matrix(), n_rows, n_cols, thread_count);
+
+        std::vector<float> depth;
+        renderer.render(poses, depth, bad_value);
+        EXPECT_EQ(std::size_t(n_rows * n_cols), depth.size());
+
+        covered_count = 0;
+        for (int v = 0; v < n_rows; ++v)
+        {
+            for (int u = 0; u < n_cols; ++u)
+            {
+                const bool hit = std::isfinite(cast_ray(boxes, u, v));
+                bool stable = true;
+                for (double du : {-silhouette_margin, silhouette_margin})
+                {
+                    for (double dv : {-silhouette_margin, silhouette_margin})
+                    {
+                        stable &= std::isfinite(cast_ray(
+                                      boxes, u + du, v + dv)) == hit;
+                    }
+                }
+                if (!stable) continue;
+
+                const float actual = depth[v * n_cols + u];
+                if (!hit)
+                {
+                    EXPECT_EQ(bad_value, actual)
+                        << "pixel " << u << ", " << v << ", "
+                        << thread_count << " threads";
+                    continue;
+                }
+
+                const double expected = cast_ray(boxes, u, v);
+                EXPECT_NEAR(expected, actual, tolerance * expected)
+                    << "pixel " << u << ", " << v << ", " << thread_count
+                    << " threads";
+                covered_count++;
+            }
+        }
+    }
+
+    return covered_count;
+}
+
+Eigen::Matrix3d rotation(double x, double y, double z)
+{
+    return (Eigen::AngleAxisd(z, Eigen::Vector3d::UnitZ()) *
+            Eigen::AngleAxisd(y, Eigen::Vector3d::UnitY()) *
+            Eigen::AngleAxisd(x, Eigen::Vector3d::UnitX()))
+        .toRotationMatrix();
+}
+}
+
+TEST(TileDepthRendererTest, AxisAlignedBox)
+{
+    const Box box{Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, 1)};
+    EXPECT_GT(expect_analytic_depths({box}), 100);
+
+    // the front face is parallel to the image plane
+    dbrt::TileDepthRenderer renderer(
+        {box_mesh()}, camera_matrix(), n_rows, n_cols);
+    std::vector<float> depth;
+    renderer.render({link_pose(box)}, depth, bad_value);
+    EXPECT_NEAR(0.92, depth[54 * n_cols + 74], tolerance);
+}
+
+TEST(TileDepthRendererTest, RotatedBox)
+{
+    const Box box{rotation(0.4, 0.5, 0.3), Eigen::Vector3d(0.05, -0.03, 0.8)};
+    EXPECT_GT(expect_analytic_depths({box}), 100);
+}
+
+TEST(TileDepthRendererTest, NearestOfOverlappingBoxes)
+{
+    // the boxes overlap in the image and intersect each other
+    const std::vector<Box> boxes = {
+        {rotation(0.2, -0.6, 0.1), Eigen::Vector3d(-0.08, 0.02, 0.9)},
+        {rotation(-0.3, 0.2, 0.7), Eigen::Vector3d(0.02, 0.0, 0.95)},
+        {rotation(0.0, 0.0, 0.0), Eigen::Vector3d(0.1, -0.1, 1.5)}};
+    EXPECT_GT(expect_analytic_depths(boxes), 100);
+}
+
+TEST(TileDepthRendererTest, LinksOutsideOfTheFrustumAreCulled)
+{
+    const Box behind{Eigen::Matrix3d::Identity(), Eigen::Vector3d(0, 0, -1)};
+    const Box beside{Eigen::Matrix3d::Identity(), Eigen::Vector3d(5, 0, 1)};
+
+    dbrt::TileDepthRenderer renderer(
+        {box_mesh(), box_mesh()}, camera_matrix(), n_rows, n_cols);
+    std::vector<float> depth;
+    renderer.render({link_pose(behind), link_pose(beside)}, depth, bad_value);
+
+    EXPECT_EQ(2u, renderer.culled_link_count());
+    for (float d : depth) ASSERT_EQ(bad_value, d);
+}
+
+int main(int argc, char** argv)
+{
+    testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}